@@ -2,6 +2,8 @@
 
 // Forward declaration for the Constraints
 #include "CBS.h"
+#include "ReservationTable.h"
+#include <climits>
 
 // Updated Node constructor with time_step
 Node::Node(int _row, int _col, double g, double h, int _time_step, std::shared_ptr<Node> _parent)
@@ -16,6 +18,10 @@ struct NodeComparator {
 
 AStar::AStar(std::shared_ptr<Map> _map) : map(std::move(_map)) {}
 
+void AStar::SetWindow(int _window) {
+  window = _window;
+}
+
 // Original FindPath method (without constraints) - forward to the new one with empty constraints
 std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col, int goal_row, int goal_col, int agent_id, int start_time) {
     Constraints empty_constraints;
@@ -24,6 +30,18 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
 
 // New FindPath method with constraints
 std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col, int goal_row, int goal_col, int agent_id, int start_time, const Constraints& constraints) {
+  return Search(start_row, start_col, goal_row, goal_col, agent_id, start_time, constraints, nullptr);
+}
+
+// FindPath method that plans around reserved paths instead of constraints
+std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col, int goal_row, int goal_col, int agent_id, int start_time, const ReservationTable& reservations) {
+  Constraints empty_constraints;
+  return Search(start_row, start_col, goal_row, goal_col, agent_id, start_time, empty_constraints, &reservations);
+}
+
+std::vector<std::shared_ptr<Cell>> AStar::Search(int start_row, int start_col, int goal_row, int goal_col, int agent_id, int start_time, const Constraints& constraints, const ReservationTable* reservations) {
+  last_stats = SearchStats();
+  MAPF_STATS_TIMER(search_timer, last_stats.search_ms);
   if (!map->IsInBounds(start_row, start_col) || !map->IsInBounds(goal_row, goal_col)) {
     return {}; // Return empty path if out of bounds
   }
@@ -33,20 +51,43 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
     return {}; // Cannot start at a constrained position
   }
 
+  // Check if start position is already reserved
+  if (reservations && reservations->IsVertexReserved(start_row, start_col, start_time)) {
+    return {}; // Cannot start at a reserved position
+  }
+
+  // Check if another agent holds the goal forever
+  if (reservations && reservations->GetLastReservedTime(goal_row, goal_col) == INT_MAX) {
+    return {}; // The goal can never be occupied for good
+  }
+
   // Priority queue (min-heap) for open set
   std::priority_queue<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>, NodeComparator> open_set;
 
   // Maps (row, col, time) -> Node to track g_costs
   std::unordered_map<std::string, std::shared_ptr<Node>> all_nodes;
 
+  // After the last constraint or reservation the world is static, so later time steps share one key
+  int static_time = std::max(start_time, constraints.getMaxConstraintTime(agent_id));
+  if (reservations) {
+    static_time = std::max(static_time, reservations->GetMaxTime() + 1);
+  }
+  auto make_key = [static_time](int row, int col, int time) {
+    return std::to_string(row) + "," + std::to_string(col) + "," + std::to_string(std::min(time, static_time));
+  };
+
+  // The agent may only stop at its goal once no constraint forbids it to stay there
+  int goal_constraint_time = constraints.getLastVertexConstraintTime(agent_id, goal_row, goal_col);
+
   // Start node with time_step
   auto start_node = std::make_shared<Node>(start_row, start_col, 0.0, 
                                          map->Heuristic(start_row, start_col, goal_row, goal_col), 
                                          start_time, nullptr);
   open_set.push(start_node);
+  MAPF_STATS(last_stats.generated++);
   
   // Use a key that includes time_step to handle waiting at the same location
-  std::string start_key = std::to_string(start_row) + "," + std::to_string(start_col) + "," + std::to_string(start_time);
+  std::string start_key = make_key(start_row, start_col, start_time);
   all_nodes[start_key] = start_node;
 
   // Set to track visited cells at specific times
@@ -68,23 +109,41 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
       return {}; // No path found within time limit
     }
 
-    // If goal reached, reconstruct path
-    if (row == goal_row && col == goal_col) {
-      return ReconstructPath(current_node, agent_id, start_time);
+    // Past the window nothing is checked any more: follow a shortest route to the goal
+    if (window > 0 && time >= start_time + window) {
+      auto path = ReconstructPath(current_node, start_time);
+      if (!CompletePath(path, goal_row, goal_col)) {
+        return {};
+      }
+      return path;
+    }
+
+    // If goal reached, reconstruct path (only if no constraint or reserved agent needs the goal later)
+    if (row == goal_row && col == goal_col && goal_constraint_time < time &&
+        (!reservations || reservations->GetLastReservedTime(row, col) < time)) {
+      return ReconstructPath(current_node, start_time);
     }
 
-    std::string key = std::to_string(row) + "," + std::to_string(col) + "," + std::to_string(time);
+    std::string key = make_key(row, col, time);
     if (closed_set.find(key) != closed_set.end()) continue;
     closed_set.insert(key);
+    last_stats.expansions++;
+
+    // Reading the clock is not free, so only check the deadline now and then
+    if ((last_stats.expansions & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) {
+      return {};
+    }
 
     // Add "wait" action - agent stays at the same location
     {
       int next_time = time + 1;
       // Check if waiting violates any constraints
-      if (!constraints.hasVertexConstraint(agent_id, row, col, next_time)) {
+      MAPF_STATS(last_stats.constraint_lookups++);
+      if (!constraints.hasVertexConstraint(agent_id, row, col, next_time) &&
+          (!reservations || !reservations->IsVertexReserved(row, col, next_time))) {
         double g_cost = current_node->g_cost + 1.0; // Cost of waiting is 1
         
-        std::string next_key = std::to_string(row) + "," + std::to_string(col) + "," + std::to_string(next_time);
+        std::string next_key = make_key(row, col, next_time);
         if (closed_set.find(next_key) == closed_set.end() && 
             (!all_nodes[next_key] || g_cost < all_nodes[next_key]->g_cost)) {
           
@@ -93,6 +152,7 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
                                                next_time, current_node);
           all_nodes[next_key] = wait_node;
           open_set.push(wait_node);
+          MAPF_STATS(last_stats.generated++);
         }
       }
     }
@@ -110,10 +170,15 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
         continue;
       }
 
+      // Check if the move collides with a reserved path
+      if (reservations && ViolatesReservations(row, col, nrow, ncol, time, *reservations)) {
+        continue;
+      }
+
       double g_cost = current_node->g_cost + map->GetMovementCost(row, col, nrow, ncol);
       double h_cost = map->Heuristic(nrow, ncol, goal_row, goal_col);
       
-      std::string next_key = std::to_string(nrow) + "," + std::to_string(ncol) + "," + std::to_string(next_time);
+      std::string next_key = make_key(nrow, ncol, next_time);
       
       // Check if this node has been visited and whether we can improve the cost
       if (closed_set.find(next_key) == closed_set.end() && 
@@ -127,6 +192,7 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
         
         // Push the neighbor node to the open set
         open_set.push(neighbor_node);
+        MAPF_STATS(last_stats.generated++);
       }
     }
   }
@@ -136,6 +202,7 @@ std::vector<std::shared_ptr<Cell>> AStar::FindPath(int start_row, int start_col,
 
 // Helper function to check if a move violates constraints
 bool AStar::ViolatesConstraints(int agent_id, int row1, int col1, int row2, int col2, int time, const Constraints& constraints) {
+  MAPF_STATS(last_stats.constraint_lookups++);
   // Check vertex constraint on the next position
   if (constraints.hasVertexConstraint(agent_id, row2, col2, time + 1)) {
     return true;
@@ -149,7 +216,22 @@ bool AStar::ViolatesConstraints(int agent_id, int row1, int col1, int row2, int
   return false;
 }
 
-std::vector<std::shared_ptr<Cell>> AStar::ReconstructPath(std::shared_ptr<Node> goal_node, int agent_id, int start_time) {
+// Helper function to check if a move collides with reserved paths
+bool AStar::ViolatesReservations(int row1, int col1, int row2, int col2, int time, const ReservationTable& reservations) {
+  // Check if the next position is reserved
+  if (reservations.IsVertexReserved(row2, col2, time + 1)) {
+    return true;
+  }
+  
+  // Check if a reserved agent swaps positions with this move
+  if (reservations.IsEdgeReserved(row1, col1, row2, col2, time)) {
+    return true;
+  }
+  
+  return false;
+}
+
+std::vector<std::shared_ptr<Cell>> AStar::ReconstructPath(std::shared_ptr<Node> goal_node, int start_time) {
   std::vector<std::shared_ptr<Cell>> path;
   auto current = goal_node;
   
@@ -163,13 +245,8 @@ std::vector<std::shared_ptr<Cell>> AStar::ReconstructPath(std::shared_ptr<Node>
   while (current) {
     int time_index = current->time_step - start_time;
     if (time_index >= 0 && time_index < path.size()) {
-      std::shared_ptr<Cell> cell = map->GetCell(current->row, current->col);
-      
-      // Update the occupancy map with the agent ID at the current time
-      cell->occupancy_map[current->time_step].push_back(agent_id);
-      
       // Store the cell at the right position in the path
-      path[time_index] = cell;
+      path[time_index] = map->GetCell(current->row, current->col);
     }
     
     // Move to the parent node to continue reconstructing the path
@@ -177,4 +254,26 @@ std::vector<std::shared_ptr<Cell>> AStar::ReconstructPath(std::shared_ptr<Node>
   }
   
   return path;
-}
\ No newline at end of file
+}
+
+bool AStar::CompletePath(std::vector<std::shared_ptr<Cell>>& path, int goal_row, int goal_col) {
+  auto distances = map->GetDistanceTable(map->GetIndex(goal_row, goal_col));
+  int index = map->GetIndex(path.back()->row, path.back()->col);
+  if (distances[index] == Map::UNREACHABLE) {
+    return false;
+  }
+
+  // Step to a neighbor one move closer until the goal is reached
+  while (distances[index] > 0) {
+    int neighbors[8];
+    for (int k = 0, count = map->GetNeighborIds(index, neighbors); k < count; k++) {
+      if (distances[neighbors[k]] == distances[index] - 1) {
+        index = neighbors[k];
+        break;
+      }
+    }
+
+    path.push_back(map->GetCell(map->GetRow(index), map->GetCol(index)));
+  }
+  return true;
+}
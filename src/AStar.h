@@ -16,9 +16,12 @@
 #include <memory>
 #include <string>
 #include <algorithm>
+#include <chrono>
 #include "Map.h"
+#include "SolverStats.h"
 
 // Forward declaration for Constraints
+class ReservationTable;
 struct Constraints;
 struct VertexConstraint;
 struct EdgeConstraint;
@@ -98,19 +101,110 @@ public:
                                               int agent_id, int start_time, 
                                               const Constraints& constraints);
 
+    /**
+     * @brief Finds a path that avoids the paths stored in a reservation table.
+     * 
+     * The returned path only ends at the goal if no reserved agent passes
+     * through the goal afterwards.
+     * 
+     * @param start_row Starting row
+     * @param start_col Starting column
+     * @param goal_row Goal row
+     * @param goal_col Goal column
+     * @param agent_id ID of the agent
+     * @param start_time Starting time step
+     * @param reservations Space-time reservations of higher-priority agents
+     * @return Vector of cells representing the path
+     */
+    std::vector<std::shared_ptr<Cell>> FindPath(int start_row, int start_col, 
+                                              int goal_row, int goal_col, 
+                                              int agent_id, int start_time, 
+                                              const ReservationTable& reservations);
+
+    /**
+     * @brief Limits the time-expanded search to a window after the start time.
+     * 
+     * Constraints and reservations later than the window are ignored. Once
+     * the search reaches the end of the window, the rest of the path follows
+     * the map's distance table to the goal, so the search cost does not grow
+     * with the path length.
+     * 
+     * @param window Number of time steps to plan with constraints, 0 for no limit
+     */
+    void SetWindow(int window);
+
+    /**
+     * @brief Gets the work done by the last FindPath() call.
+     */
+    const SearchStats& GetLastStats() const { return last_stats; }
+
+    /**
+     * @brief Makes searches that are still running at a point in time give up and return no path.
+     *
+     * @param _deadline Point in time to stop at
+     */
+    void SetDeadline(std::chrono::steady_clock::time_point _deadline) { deadline = _deadline; }
+
 private:
     std::shared_ptr<Map> map;  ///< Shared pointer to the map
+    int window = 0;  ///< Time steps planned with constraints, 0 for no limit
+    SearchStats last_stats;  ///< Work done by the last search
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();  ///< When searches give up
     
+    /**
+     * @brief Runs the time-expanded A* search.
+     * 
+     * @param start_row Starting row
+     * @param start_col Starting column
+     * @param goal_row Goal row
+     * @param goal_col Goal column
+     * @param agent_id ID of the agent
+     * @param start_time Starting time step
+     * @param constraints Set of constraints to satisfy
+     * @param reservations Reservations to avoid, or nullptr for none
+     * @return Vector of cells representing the path
+     */
+    std::vector<std::shared_ptr<Cell>> Search(int start_row, int start_col, 
+                                            int goal_row, int goal_col, 
+                                            int agent_id, int start_time, 
+                                            const Constraints& constraints,
+                                            const ReservationTable* reservations);
+
+    /**
+     * @brief Checks if a move collides with a reserved path.
+     * 
+     * @param row1 Starting row
+     * @param col1 Starting column
+     * @param row2 Ending row
+     * @param col2 Ending column
+     * @param time Time step
+     * @param reservations Reservations to check
+     * @return true if the move collides with a reservation
+     */
+    bool ViolatesReservations(int row1, int col1, 
+                            int row2, int col2, int time, 
+                            const ReservationTable& reservations);
+
     /**
      * @brief Reconstructs the path from a goal node.
      * 
+     * Only reads the map, so searches on several threads may share it.
+     * 
      * @param goal_node Pointer to the goal node
-     * @param agent_id ID of the agent
      * @param start_time Starting time step
      * @return Vector of cells representing the path
      */
-    std::vector<std::shared_ptr<Cell>> ReconstructPath(std::shared_ptr<Node> goal_node, 
-                                                     int agent_id, int start_time);
+    std::vector<std::shared_ptr<Cell>> ReconstructPath(std::shared_ptr<Node> goal_node, int start_time);
+
+    /**
+     * @brief Extends a path along a shortest route to the goal.
+     * 
+     * @param path Path to extend, must not be empty
+     * @param goal_row Goal row
+     * @param goal_col Goal column
+     * @return false if the goal cannot be reached from the end of the path
+     */
+    bool CompletePath(std::vector<std::shared_ptr<Cell>>& path, int goal_row, int goal_col);
     
     /**
      * @brief Checks if a move violates any constraints.
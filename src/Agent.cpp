@@ -10,3 +10,11 @@ std::vector<std::shared_ptr<Cell>> Agent::GetPath() const { return path; }
 
 // Setters
 void Agent::SetPath(std::vector<std::shared_ptr<Cell>> new_path) { path = std::move(new_path); }
+void Agent::SetStart(int row, int col) {
+  data.start_row = row;
+  data.start_col = col;
+}
+void Agent::SetGoal(int row, int col) {
+  data.dest_row = row;
+  data.dest_col = col;
+}
\ No newline at end of file
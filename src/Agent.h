@@ -79,6 +79,24 @@ public:
      */
     void SetPath(std::vector<std::shared_ptr<Cell>> new_path);
 
+    /**
+     * @brief Moves the agent's start position.
+     * 
+     * Rolling-horizon planning calls this after executing part of a plan.
+     * 
+     * @param row New start row
+     * @param col New start column
+     */
+    void SetStart(int row, int col);
+
+    /**
+     * @brief Assigns a new destination to the agent.
+     * 
+     * @param row New destination row
+     * @param col New destination column
+     */
+    void SetGoal(int row, int col);
+
 private:
     AgentData data;  ///< Agent's data structure
     std::vector<std::shared_ptr<Cell>> path;  ///< Agent's current path
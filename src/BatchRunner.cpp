@@ -0,0 +1,198 @@
+#include "BatchRunner.h"
+#include "Manager.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+BatchRunner::BatchRunner(std::shared_ptr<Map> _map, SolverFactory _factory)
+  : map(std::move(_map)), factory(std::move(_factory)) {}
+
+void BatchRunner::SetAgentSweep(int first, int step) {
+  first_count = std::max(1, first);
+  count_step = std::max(1, step);
+}
+
+void BatchRunner::SetTimeLimit(double seconds) {
+  time_limit = seconds;
+}
+
+void BatchRunner::SetThreadCount(int count) {
+  thread_count = count > 0 ? count : std::max(1u, std::thread::hardware_concurrency());
+}
+
+ResultSink::~ResultSink() {
+  Drain();
+}
+
+void ResultSink::Push(InstanceResult result) {
+  Node* node = new Node{std::move(result), head.load(std::memory_order_relaxed)};
+  while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<InstanceResult> ResultSink::Drain() {
+  std::vector<InstanceResult> results;
+  for (Node* node = head.exchange(nullptr, std::memory_order_acquire); node != nullptr;) {
+    Node* next = node->next;
+    results.push_back(std::move(node->result));
+    delete node;
+    node = next;
+  }
+  std::reverse(results.begin(), results.end());
+  return results;
+}
+
+std::vector<InstanceResult> BatchRunner::RunFolder(const std::string& folder_path) {
+  namespace fs = std::filesystem;
+  if (!fs::is_directory(folder_path)) {
+    throw std::runtime_error("Scenario folder not found: " + folder_path);
+  }
+
+  std::vector<std::string> scenario_paths;
+  for (const auto& entry : fs::directory_iterator(folder_path)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".scen") {
+      scenario_paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(scenario_paths.begin(), scenario_paths.end());
+
+  // Read everything up front, so the workers have nothing left that can fail
+  std::vector<std::string> names;
+  std::vector<std::vector<AgentData>> scenarios;
+  for (const std::string& path : scenario_paths) {
+    names.push_back(fs::path(path).stem().string());
+    scenarios.push_back(Manager::ReadScenario(path));
+  }
+
+  ResultSink sink;
+  {
+    ThreadPool pool(std::min<int>(thread_count, std::max<size_t>(1, scenarios.size())));
+    for (size_t i = 0; i < scenarios.size(); i++) {
+      pool.Submit([this, &names, &scenarios, &sink, i]() {
+        RunScenario(names[i], scenarios[i], sink);
+      });
+    }
+    pool.Wait();
+  }
+
+  // Workers finish in any order
+  std::vector<InstanceResult> results = sink.Drain();
+  std::stable_sort(results.begin(), results.end(), [](const InstanceResult& a, const InstanceResult& b) {
+    return a.scenario != b.scenario ? a.scenario < b.scenario : a.agents_count < b.agents_count;
+  });
+  return results;
+}
+
+void BatchRunner::RunScenario(const std::string& scenario, const std::vector<AgentData>& entries, ResultSink& sink) {
+  int solved = 0;
+  for (int count = first_count; count <= static_cast<int>(entries.size()); count += count_step) {
+    InstanceResult result = RunInstance(scenario, entries, count);
+    bool success = result.success;
+    sink.Push(std::move(result));
+    if (!success) {
+      break;
+    }
+    solved = count;
+  }
+
+  // One write per line, so lines from several workers do not interleave
+  std::ostringstream line;
+  line << scenario << ": solved up to " << solved << " of " << entries.size() << " agents\n";
+  std::cout << line.str() << std::flush;
+}
+
+InstanceResult BatchRunner::RunInstance(const std::string& scenario, const std::vector<AgentData>& entries, int agents_count) {
+  std::vector<std::shared_ptr<Agent>> agents;
+  agents.reserve(agents_count);
+  for (int i = 0; i < agents_count; i++) {
+    const AgentData& data = entries[i];
+    agents.push_back(std::make_shared<Agent>(i, data.start_row, data.start_col, data.dest_row, data.dest_col,
+                                             data.optimal_distance, map));
+  }
+
+  // The map is shared with the other workers, so the solver must not draw on it,
+  // and engine messages would interleave with the lines of the other workers
+  std::shared_ptr<Solver> solver = factory(agents);
+  solver->SetUpdateMap(false);
+  solver->SetVerbose(false);
+  auto start = std::chrono::steady_clock::now();
+  solver->SetDeadline(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(time_limit)));
+  bool found = solver->PathFind();
+  auto end = std::chrono::steady_clock::now();
+
+  InstanceResult result;
+  result.scenario = scenario;
+  result.agents_count = agents_count;
+  result.runtime_ms = std::chrono::duration<double, std::milli>(end - start).count();
+  result.timed_out = solver->TimedOut() || result.runtime_ms > time_limit * 1000.0;
+  result.success = found && !result.timed_out;
+  result.sum_of_costs = 0;
+  if (result.success) {
+    for (const auto& agent : agents) {
+      result.sum_of_costs += agent->GetPath().size();
+    }
+  }
+  result.high_level_nodes = solver->GetStats().high_level_expanded;
+  result.low_level_expansions = solver->GetStats().low_level_expansions;
+  return result;
+}
+
+bool BatchRunner::WriteCsv(const std::string& path, const std::vector<InstanceResult>& results) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Error: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  file << "scenario,agents,success,timed_out,runtime_ms,sum_of_costs,high_level_nodes,low_level_expansions\n";
+  for (const InstanceResult& result : results) {
+    file << result.scenario << ',' << result.agents_count << ',' << (result.success ? 1 : 0) << ','
+         << (result.timed_out ? 1 : 0) << ','
+         << result.runtime_ms << ',' << result.sum_of_costs << ',' << result.high_level_nodes << ','
+         << result.low_level_expansions << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+bool BatchRunner::WriteJson(const std::string& path, const std::vector<InstanceResult>& results) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Error: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  // Scenario names come from file names, so only quotes and backslashes need escaping
+  auto quote = [](const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+      if (c == '"' || c == '\\') {
+        quoted += '\\';
+      }
+      quoted += c;
+    }
+    return quoted + "\"";
+  };
+
+  file << "[\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const InstanceResult& result = results[i];
+    file << "  {\"scenario\": " << quote(result.scenario)
+         << ", \"agents\": " << result.agents_count
+         << ", \"success\": " << (result.success ? "true" : "false")
+         << ", \"timed_out\": " << (result.timed_out ? "true" : "false")
+         << ", \"runtime_ms\": " << result.runtime_ms
+         << ", \"sum_of_costs\": " << result.sum_of_costs
+         << ", \"high_level_nodes\": " << result.high_level_nodes
+         << ", \"low_level_expansions\": " << result.low_level_expansions << "}"
+         << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  file << "]\n";
+  return static_cast<bool>(file);
+}
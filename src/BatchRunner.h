@@ -0,0 +1,188 @@
+/**
+ * @file BatchRunner.h
+ * @brief Defines the batch benchmark runner over whole scenario folders.
+ *
+ * The map is loaded once. For every scenario in a folder the runner solves
+ * the first agents of the scenario with growing agent counts, until the
+ * engine fails or runs out of time, and records one result per instance.
+ * This is how the capacity of an engine on a map is tracked.
+ *
+ * Scenarios are independent, so they run in parallel on a thread pool.
+ * All instances share the read-only map and its precomputed tables; each
+ * has its own agents and solver and never writes to the map.
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include <atomic>
+#include "Map.h"
+#include "Agent.h"
+#include "Solver.h"
+
+/**
+ * @brief Outcome of one solved instance: one scenario with one agent count.
+ */
+struct InstanceResult {
+    std::string scenario;            ///< Scenario name, without folder and extension
+    int agents_count;                ///< Number of agents taken from the scenario
+    bool success;                    ///< Whether a solution was found within the time limit
+    bool timed_out;                  ///< Whether the instance ran into the time limit
+    double runtime_ms;               ///< Wall-clock time of the engine in milliseconds
+    long long sum_of_costs;          ///< Sum of the path lengths, as the engines print it; 0 on failure
+    long long high_level_nodes;      ///< High-level nodes expanded, e.g. CBS constraint tree nodes
+    long long low_level_expansions;  ///< Nodes expanded by all low-level A* searches
+};
+
+/**
+ * @brief Collects results from several threads without locking.
+ *
+ * Push() prepends to a singly linked list with a compare-and-swap, so
+ * workers never wait for each other to record a result.
+ */
+class ResultSink {
+public:
+    ResultSink() = default;
+    ~ResultSink();
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    /**
+     * @brief Adds a result; safe to call from any number of threads.
+     *
+     * @param result Result to add
+     */
+    void Push(InstanceResult result);
+
+    /**
+     * @brief Takes all results added so far, in the order they were added.
+     *
+     * Must not run concurrently with Push() calls whose results are expected.
+     *
+     * @return The results; the sink is empty afterwards
+     */
+    std::vector<InstanceResult> Drain();
+
+private:
+    /**
+     * @brief List entry holding one result.
+     */
+    struct Node {
+        InstanceResult result;  ///< Stored result
+        Node* next;             ///< Result added before this one
+    };
+
+    std::atomic<Node*> head{nullptr};  ///< Result added last
+};
+
+/**
+ * @brief Sweeps agent counts over every scenario of a folder on one shared map.
+ */
+class BatchRunner {
+public:
+    /**
+     * @brief Creates the engine for one instance; the agents outlive the solver.
+     *
+     * Called from the worker threads, so it must only read shared state.
+     */
+    using SolverFactory = std::function<std::shared_ptr<Solver>(std::vector<std::shared_ptr<Agent>>& agents)>;
+
+    /**
+     * @brief Constructs a runner.
+     *
+     * @param _map Shared pointer to the loaded map
+     * @param _factory Creates a configured engine for each instance
+     */
+    BatchRunner(std::shared_ptr<Map> _map, SolverFactory _factory);
+
+    /**
+     * @brief Sets the agent counts tried on each scenario.
+     *
+     * Counts go from `first` up in steps of `step`, until an instance fails
+     * or the scenario runs out of agents.
+     *
+     * @param first Smallest agent count
+     * @param step Increase between two instances
+     */
+    void SetAgentSweep(int first, int step);
+
+    /**
+     * @brief Sets the time limit of each instance.
+     *
+     * The engine gets it as a deadline and gives up cooperatively; an
+     * instance that still overruns counts as failed.
+     *
+     * @param seconds Time limit per instance
+     */
+    void SetTimeLimit(double seconds);
+
+    /**
+     * @brief Sets how many scenarios are solved at the same time.
+     *
+     * @param count Number of worker threads, 0 for one per hardware thread
+     */
+    void SetThreadCount(int count);
+
+    /**
+     * @brief Runs the sweep on every `.scen` file of a folder.
+     *
+     * All scenarios are read before the first instance starts.
+     *
+     * @param folder_path Path to the scenario folder
+     * @return One result per instance, ordered by scenario name and agent count
+     * @throw std::runtime_error if the folder or a scenario cannot be read
+     */
+    std::vector<InstanceResult> RunFolder(const std::string& folder_path);
+
+    /**
+     * @brief Runs the sweep on one scenario.
+     *
+     * @param scenario Name recorded in the results
+     * @param entries Start and goal of every agent of the scenario
+     * @param sink Output: one result per instance is added
+     */
+    void RunScenario(const std::string& scenario, const std::vector<AgentData>& entries, ResultSink& sink);
+
+    /**
+     * @brief Solves the first agents of a scenario once.
+     *
+     * @param scenario Name recorded in the result
+     * @param entries Start and goal of every agent of the scenario
+     * @param agents_count Number of agents to take
+     * @return Outcome of the instance
+     */
+    InstanceResult RunInstance(const std::string& scenario, const std::vector<AgentData>& entries, int agents_count);
+
+    /**
+     * @brief Writes results as CSV with a header row.
+     *
+     * @param path Output file
+     * @param results Results to write
+     * @return false (after printing an error) if the file cannot be written
+     */
+    static bool WriteCsv(const std::string& path, const std::vector<InstanceResult>& results);
+
+    /**
+     * @brief Writes results as a JSON array of objects.
+     *
+     * @param path Output file
+     * @param results Results to write
+     * @return false (after printing an error) if the file cannot be written
+     */
+    static bool WriteJson(const std::string& path, const std::vector<InstanceResult>& results);
+
+private:
+    std::shared_ptr<Map> map;  ///< Map shared by all instances
+    SolverFactory factory;     ///< Creates the engine of each instance
+    int first_count = 1;       ///< Smallest agent count
+    int count_step = 1;        ///< Increase of the agent count between instances
+    double time_limit = 60.0;  ///< Seconds after which an instance counts as failed
+    int thread_count = 1;      ///< Scenarios solved at the same time
+};
+
+#endif // BATCH_RUNNER_H
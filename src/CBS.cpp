@@ -1,4 +1,5 @@
 #include "CBS.h"
+#include <algorithm>
 
 bool VertexConstraint::operator==(const VertexConstraint& other) const {
   return agent_id == other.agent_id && row == other.row && 
@@ -11,21 +12,125 @@ bool EdgeConstraint::operator==(const EdgeConstraint& other) const {
          col2 == other.col2 && time == other.time;
 }
 
+bool RangeConstraint::operator==(const RangeConstraint& other) const {
+  return agent_id == other.agent_id && row == other.row && 
+         col == other.col && time_min == other.time_min && 
+         time_max == other.time_max;
+}
+
 bool Constraints::hasVertexConstraint(int agent_id, int row, int col, int time) const {
-  return vertex_constraints.count(VertexConstraint{agent_id, row, col, time}) > 0;
+  if (vertex_constraints.count(VertexConstraint{agent_id, row, col, time}) > 0) {
+    return true;
+  }
+
+  // Range constraints are few, so a scan is cheaper than an index
+  for (const auto& rc : range_constraints) {
+    if (rc.agent_id == agent_id && rc.row == row && rc.col == col &&
+        time >= rc.time_min && time <= rc.time_max) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool Constraints::hasEdgeConstraint(int agent_id, int row1, int col1, int row2, int col2, int time) const {
   return edge_constraints.count(EdgeConstraint{agent_id, row1, col1, row2, col2, time}) > 0;
 }
 
+int Constraints::getLastVertexConstraintTime(int agent_id, int row, int col) const {
+  int last = -1;
+  for (const auto& vc : vertex_constraints) {
+    if (vc.agent_id == agent_id && vc.row == row && vc.col == col) last = std::max(last, vc.time);
+  }
+  for (const auto& rc : range_constraints) {
+    if (rc.agent_id == agent_id && rc.row == row && rc.col == col) last = std::max(last, rc.time_max);
+  }
+  return last;
+}
+
+int Constraints::getMaxConstraintTime(int agent_id) const {
+  int last = -1;
+  for (const auto& vc : vertex_constraints) {
+    if (vc.agent_id == agent_id) last = std::max(last, vc.time);
+  }
+  for (const auto& ec : edge_constraints) {
+    if (ec.agent_id == agent_id) last = std::max(last, ec.time + 1);
+  }
+  for (const auto& rc : range_constraints) {
+    if (rc.agent_id == agent_id) last = std::max(last, rc.time_max);
+  }
+  return last;
+}
+
+bool Constraints::addVertexConstraint(const VertexConstraint& constraint) {
+  if (!vertex_constraints.insert(constraint).second) return false;
+  uint64_t h = std::hash<VertexConstraint>()(constraint);
+  hash += h;
+  agent_hashes[constraint.agent_id] += h;
+  return true;
+}
+
+bool Constraints::addEdgeConstraint(const EdgeConstraint& constraint) {
+  if (!edge_constraints.insert(constraint).second) return false;
+  uint64_t h = std::hash<EdgeConstraint>()(constraint);
+  hash += h;
+  agent_hashes[constraint.agent_id] += h;
+  return true;
+}
+
+bool Constraints::addRangeConstraint(const RangeConstraint& constraint) {
+  if (!range_constraints.insert(constraint).second) return false;
+  uint64_t h = std::hash<RangeConstraint>()(constraint);
+  hash += h;
+  agent_hashes[constraint.agent_id] += h;
+  return true;
+}
+
+uint64_t Constraints::getAgentHash(int agent_id) const {
+  auto it = agent_hashes.find(agent_id);
+  return it == agent_hashes.end() ? 0 : it->second;
+}
+
+void Constraints::merge(const Constraints& other) {
+  // Only constraints that are new to this set change the hash
+  for (const auto& vc : other.vertex_constraints) addVertexConstraint(vc);
+  for (const auto& ec : other.edge_constraints) addEdgeConstraint(ec);
+  for (const auto& rc : other.range_constraints) addRangeConstraint(rc);
+}
+
 bool CBSNode::operator>(const CBSNode& other) const {
   return cost > other.cost;
 }
 
-CBS::CBS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents) : map(_map), agents(_agents) {}
+CBS::CBS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents) : Solver(_map, _agents) {}
+
+void CBS::SetPublishSolution(bool publish) {
+  publish_solution = publish;
+}
+
+void CBS::SetMaxIterations(int iterations) {
+  max_iterations = std::max(1, iterations);
+}
+
+void CBS::SetPathCacheSize(size_t size) {
+  path_cache_size = size;
+}
+
+void CBS::SetHierarchy(std::shared_ptr<const HierarchicalMap> _hierarchy) {
+  hierarchy = std::move(_hierarchy);
+}
+
+void CBS::SetWindow(int _window) {
+  window = std::max(0, _window);
+}
+
+const std::vector<std::vector<std::shared_ptr<Cell>>>& CBS::GetSolution() const {
+  return solution;
+}
+
+bool CBS::PathFind() {
+  BeginPathFind();
 
-void CBS::PathFind() {
   // Create root node
   CBSNode root;
   root.constraints = Constraints();  // Empty constraints
@@ -33,227 +138,400 @@ void CBS::PathFind() {
   
   // Find initial paths for all agents
   AStar astar(map);
+  astar.SetWindow(window);
+  astar.SetDeadline(deadline);
+  PathCache path_cache(path_cache_size);
   bool all_paths_found = true;
   
-  for (size_t i = 0; i < agents.size(); i++) {
-    auto& agent = agents[i];
-    auto path = astar.FindPath(
-      agent->GetAgentData().start_row, 
-      agent->GetAgentData().start_col, 
-      agent->GetAgentData().dest_row, 
-      agent->GetAgentData().dest_col, 
-      i, 0, root.constraints
-    );
-    
-    if (path.empty()) {
-      all_paths_found = false;
-      break;
+  {
+    MAPF_STATS_TIMER(root_timer, stats.root_planning_ms);
+    for (size_t i = 0; i < agents.size(); i++) {
+      std::vector<std::shared_ptr<Cell>> path;
+      const AgentData& data = agents[i]->GetAgentData();
+      if (hierarchy && window == 0 && map->IsInBounds(data.start_row, data.start_col) &&
+          map->IsInBounds(data.dest_row, data.dest_col)) {
+        for (int index : hierarchy->FindPath(map->GetIndex(data.start_row, data.start_col), map->GetIndex(data.dest_row, data.dest_col))) {
+          path.push_back(map->GetCell(map->GetRow(index), map->GetCol(index)));
+        }
+      }
+      if (path.empty()) {
+        path = FindPath(astar, path_cache, i, root.constraints);
+      }
+      
+      if (path.empty()) {
+        all_paths_found = false;
+        break;
+      }
+      
+      root.solution[i] = path;
     }
-    
-    root.solution[i] = path;
   }
   
   if (!all_paths_found) {
-    std::cerr << "No solution exists for at least one agent" << std::endl;
-    return;
+    if (DeadlinePassed()) {
+      if (verbose) {
+        std::cerr << "CBS reached its deadline while planning the root paths" << std::endl;
+      }
+      return false;
+    }
+    if (verbose) {
+      std::cerr << "No solution exists for at least one agent" << std::endl;
+    }
+    return false;
   }
   
   // Calculate the cost of the root solution
   root.cost = CalculateSolutionCost(root.solution);
   
   // Find conflicts in the root solution
-  root.conflict = FindConflict(root.solution);
+  root.conflict = FindConflict(root.solution, window);
   
   // Priority queue for CBS nodes
   std::priority_queue<CBSNode, std::vector<CBSNode>, std::greater<CBSNode>> open_list;
   open_list.push(root);
+  MAPF_STATS(stats.high_level_generated++);
+
+  // Hashes of the constraint sets already generated; different split orders can reach the same set
+  std::unordered_set<uint64_t> visited = {root.constraints.hash};
+  int duplicate_count = 0;
   
   // Main CBS loop
-  int max_iterations = 100; // Set a reasonable maximum number of iterations
   int iteration_count = 0;
   
   while (!open_list.empty()) {
     // Check if we've exceeded the maximum iterations
     if (iteration_count >= max_iterations) {
-      std::cerr << "No solution found within " << max_iterations << " iterations" << std::endl;
-      return;
+      if (verbose) {
+        std::cerr << "No solution found within " << max_iterations << " iterations" << std::endl;
+      }
+      return false;
+    }
+    if (DeadlinePassed()) {
+      if (verbose) {
+        std::cerr << "CBS reached its deadline after " << iteration_count << " iterations" << std::endl;
+      }
+      return false;
     }
     
     // Get the node with the lowest cost
     CBSNode current = open_list.top();
     open_list.pop();
+    stats.high_level_expanded++;
     
     // If there's no conflict, we found a solution
     if (!current.conflict) {
-      // Update the map with the final solution
-      UpdateMapWithSolution(current.solution);
-      
-      // Update each agent's path
-      for (size_t i = 0; i < agents.size(); i++) {
-        agents[i]->SetPath(current.solution[i]);
+      solution = current.solution;
+      if (publish_solution) {
+        // Publish the final solution to the map and the agents
+        ApplySolution(current.solution);
+        
+        if (verbose) {
+          if (duplicate_count > 0) {
+            std::cout << "CBS skipped " << duplicate_count << " duplicate constraint sets" << std::endl;
+          }
+          std::cout << "Path cache: " << path_cache.GetHits() << " hits, " << path_cache.GetMisses()
+                    << " misses (" << static_cast<int>(path_cache.GetHitRate() * 100) << "% hit rate)" << std::endl;
+          std::cout << "Solution found with cost: " << current.cost << std::endl;
+        }
       }
-      
-      std::cout << "Solution found with cost: " << current.cost << std::endl;
-      return;
+      return true;
     }
       
+    // Constraints for each branch; symmetric conflicts add a whole family at once
+    Conflict split;
+    std::array<Constraints, 2> branches;
+    GetBranchConstraints(current, split, branches);
+
     // Split the node into two branches
     for (int branch = 0; branch < 2; branch++) {
       CBSNode new_node = current;
-      int constrained_agent = (branch == 0) ? current.conflict->agent1_id : current.conflict->agent2_id;
-      
-      // Add new constraint based on conflict type
-      if (current.conflict->type == Conflict::VERTEX) {
-          // Vertex conflict: Agent cannot be at (row, col) at time
-          VertexConstraint vc{
-            constrained_agent,
-            current.conflict->row,
-            current.conflict->col,
-            current.conflict->time
-          };
-          new_node.constraints.vertex_constraints.insert(vc);
-      } else {
-        // Edge conflict: Agent cannot move from (row1, col1) to (row2, col2) at time
-        EdgeConstraint ec{
-          constrained_agent,
-          current.conflict->row1,
-          current.conflict->col1,
-          current.conflict->row2,
-          current.conflict->col2,
-          current.conflict->time
-        };
-        new_node.constraints.edge_constraints.insert(ec);
+      int constrained_agent = (branch == 0) ? split.agent1_id : split.agent2_id;
+      new_node.constraints.merge(branches[branch]);
+
+      // A constraint set seen before yields the same paths, so skip the replanning
+      if (!visited.insert(new_node.constraints.hash).second) {
+        duplicate_count++;
+        continue;
       }
       
       // Replan for the constrained agent
-      auto new_path = astar.FindPath(
-        agents[constrained_agent]->GetAgentData().start_row,
-        agents[constrained_agent]->GetAgentData().start_col,
-        agents[constrained_agent]->GetAgentData().dest_row,
-        agents[constrained_agent]->GetAgentData().dest_col,
-        constrained_agent, 0, new_node.constraints
-      );
+      auto new_path = FindPath(astar, path_cache, constrained_agent, new_node.constraints);
       
       // If path was found, update solution and continue
       if (!new_path.empty()) {
         new_node.solution[constrained_agent] = new_path;
         new_node.cost = CalculateSolutionCost(new_node.solution);
-        new_node.conflict = FindConflict(new_node.solution);
+        new_node.conflict = FindConflict(new_node.solution, window);
         open_list.push(new_node);
+        MAPF_STATS(stats.high_level_generated++);
       }
     }
     
     iteration_count++;
   }
   
-  std::cerr << "No solution found for all agents after exploring all possible paths" << std::endl;
-}
-
-std::shared_ptr<Conflict> CBS::FindConflict(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
-  // Check for conflicts between each pair of agents
-  for (size_t i = 0; i < solution.size(); i++) {
-    for (size_t j = i + 1; j < solution.size(); j++) {
-      int conflict_time = 0;
-      std::shared_ptr<Conflict> conflict = std::make_shared<Conflict>();
-      
-      if (HasConflict(solution[i], solution[j], conflict_time, conflict)) {
-        conflict->agent1_id = i;
-        conflict->agent2_id = j;
-        conflict->time = conflict_time;
-        return conflict;
-      }
-    }
+  if (verbose) {
+    std::cerr << "No solution found for all agents after exploring all possible paths" << std::endl;
   }
-  
-  return nullptr; // No conflicts found
+  return false;
 }
 
-bool CBS::HasConflict(const std::vector<std::shared_ptr<Cell>>& path1, 
-                       const std::vector<std::shared_ptr<Cell>>& path2, 
-                       int& conflict_time,
-                       std::shared_ptr<Conflict>& conflict) {
-  // Get the maximum path length
-  size_t max_length = std::max(path1.size(), path2.size());
-  
-  // Check for vertex conflicts (agents at the same position at the same time)
-  for (size_t t = 0; t < max_length; t++) {
-    // If path ended, assume agent stays at its last position
-    size_t idx1 = std::min(t, path1.size() - 1);
-    size_t idx2 = std::min(t, path2.size() - 1);
-    
-    // Check vertex conflict
-    if (path1[idx1]->row == path2[idx2]->row && path1[idx1]->col == path2[idx2]->col) {
-      conflict_time = t;
-      conflict->type = Conflict::VERTEX;
-      conflict->row = path1[idx1]->row;
-      conflict->col = path1[idx1]->col;
-      return true;
-    }
-    
-    // Check edge conflict (agents swap positions)
-    if (t > 0 && 
-      path1[idx1]->row == path2[idx2 - 1]->row && path1[idx1]->col == path2[idx2 - 1]->col &&
-      path1[idx1 - 1]->row == path2[idx2]->row && path1[idx1 - 1]->col == path2[idx2]->col) {
-      
-      conflict_time = t - 1;
-      conflict->type = Conflict::EDGE;
-      conflict->row1 = path1[idx1 - 1]->row;
-      conflict->col1 = path1[idx1 - 1]->col;
-      conflict->row2 = path1[idx1]->row;
-      conflict->col2 = path1[idx1]->col;
-      return true;
-    }
+std::vector<std::shared_ptr<Cell>> CBS::FindPath(AStar& astar, PathCache& cache, int agent_id, const Constraints& constraints) {
+  uint64_t constraint_hash = constraints.getAgentHash(agent_id);
+  std::vector<std::shared_ptr<Cell>> path;
+  if (cache.Lookup(agent_id, constraint_hash, path)) {
+    return path;
   }
-  
-  return false; // No conflict found
-}
 
-std::vector<std::shared_ptr<Cell>> CBS::FindPath(int agent_id, const Constraints& constraints) {
-  AStar astar(map);
   auto& agent = agents[agent_id];
-  
-  return astar.FindPath(
+  path = astar.FindPath(
     agent->GetAgentData().start_row,
     agent->GetAgentData().start_col,
     agent->GetAgentData().dest_row,
     agent->GetAgentData().dest_col,
     agent_id, 0, constraints
   );
+  stats.AddSearch(astar.GetLastStats());
+  cache.Insert(agent_id, constraint_hash, path);
+  return path;
 }
 
-int CBS::CalculateSolutionCost(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
-  int total_cost = 0;
-  
-  for (const auto& path : solution) {
-    // Path cost is its length
-    total_cost += path.size();
+void CBS::GetBranchConstraints(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches) {
+  split = *node.conflict;
+
+  // Symmetric constraints reach past the window, where the low-level search no longer sees them
+  if (window == 0 && (CorridorReasoning(node, split, branches) || RectangleReasoning(node, split, branches))) {
+    return;
+  }
+
+  const Conflict& conflict = *node.conflict;
+  if (conflict.type == Conflict::VERTEX) {
+    // Vertex conflict: Agent cannot be at (row, col) at time
+    branches[0].addVertexConstraint({conflict.agent1_id, conflict.row, conflict.col, conflict.time});
+    branches[1].addVertexConstraint({conflict.agent2_id, conflict.row, conflict.col, conflict.time});
+  } else {
+    // Edge conflict: agent1 moves from (row1, col1) to (row2, col2), agent2 the other way
+    branches[0].addEdgeConstraint({conflict.agent1_id, conflict.row1, conflict.col1,
+                                    conflict.row2, conflict.col2, conflict.time});
+    branches[1].addEdgeConstraint({conflict.agent2_id, conflict.row2, conflict.col2,
+                                    conflict.row1, conflict.col1, conflict.time});
   }
-  
-  return total_cost;
 }
 
-void CBS::UpdateMapWithSolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
-  // Reset the map first (clear all agent data)
-  for (int r = 0; r < map->GetHeight(); r++) {
-    for (int c = 0; c < map->GetWidth(); c++) {
-      auto cell = map->GetCell(r, c);
-      if (cell && !cell->IsObstacle()) {
-        cell->occupancy_map.clear();
-        cell->icon = '.';
-        cell->icons.clear();
+bool CBS::CorridorReasoning(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches) {
+  const Conflict& conflict = *node.conflict;
+  if (conflict.type != Conflict::VERTEX && conflict.type != Conflict::EDGE) {
+    return false;
+  }
+
+  // Find a conflict cell with exactly two neighbors
+  int cell = conflict.type == Conflict::VERTEX ? map->GetIndex(conflict.row, conflict.col)
+                                               : map->GetIndex(conflict.row1, conflict.col1);
+  if (conflict.type == Conflict::EDGE && map->GetNeighborCount(cell) != 2) {
+    cell = map->GetIndex(conflict.row2, conflict.col2);
+  }
+  if (map->GetNeighborCount(cell) != 2) {
+    return false;
+  }
+
+  // Walk along the corridor to the first cell on each side that is not part of it
+  std::unordered_set<int> corridor = {cell};
+  int ends[2];
+  for (int side = 0; side < 2; side++) {
+    int neighbors[8];
+    map->GetNeighborIds(cell, neighbors);
+    int previous = cell;
+    int current = neighbors[side];
+    while (map->GetNeighborCount(current) == 2) {
+      if (current == cell) {
+        return false;  // A ring has no ends
       }
+      corridor.insert(current);
+      map->GetNeighborIds(current, neighbors);
+      int following = neighbors[0] == previous ? neighbors[1] : neighbors[0];
+      previous = current;
+      current = following;
+    }
+    ends[side] = current;
+  }
+  if (ends[0] == ends[1]) {
+    return false;
+  }
+
+  const int agent1 = conflict.agent1_id;
+  const int agent2 = conflict.agent2_id;
+  const AgentData& data1 = agents[agent1]->GetAgentData();
+  const AgentData& data2 = agents[agent2]->GetAgentData();
+  int start1 = map->GetIndex(data1.start_row, data1.start_col);
+  int start2 = map->GetIndex(data2.start_row, data2.start_col);
+  if (corridor.count(start1) || corridor.count(start2)) {
+    return false;
+  }
+
+  // Moves needed to cross the corridor from one end to the other
+  const int length = corridor.size() + 1;
+
+  // Try both directions: agent1 leaves through exit1 and agent2 through exit2
+  for (int direction = 0; direction < 2; direction++) {
+    int exit1 = ends[1 - direction];
+    int exit2 = ends[direction];
+
+    // Earliest possible arrivals, through the corridor or around it
+    int earliest1 = map->GetDistanceTable(exit1)[start1];
+    int earliest2 = map->GetDistanceTable(exit2)[start2];
+    if (earliest1 == Map::UNREACHABLE || earliest2 == Map::UNREACHABLE) {
+      continue;
     }
+    int bypass1 = DistanceAvoiding(start1, exit1, corridor);
+    int bypass2 = DistanceAvoiding(start2, exit2, corridor);
+
+    // An agent that reaches its exit earlier must have crossed while the other could not yet
+    int last1 = std::min(bypass1 - 1, earliest2 + length);
+    int last2 = std::min(bypass2 - 1, earliest1 + length);
+    if (last1 < 0 || last2 < 0) {
+      continue;
+    }
+
+    std::array<Constraints, 2> candidate;
+    candidate[0].addRangeConstraint({agent1, map->GetRow(exit1), map->GetCol(exit1), 0, last1});
+    candidate[1].addRangeConstraint({agent2, map->GetRow(exit2), map->GetCol(exit2), 0, last2});
+
+    // Both children must rule out the current paths, or the split makes no progress
+    if (PathViolates(node.solution[agent1], agent1, candidate[0]) &&
+        PathViolates(node.solution[agent2], agent2, candidate[1])) {
+      split.type = Conflict::CORRIDOR;
+      split.row1 = map->GetRow(ends[0]);
+      split.col1 = map->GetCol(ends[0]);
+      split.row2 = map->GetRow(ends[1]);
+      split.col2 = map->GetCol(ends[1]);
+      branches = std::move(candidate);
+      return true;
+    }
+  }
+
+  return false;
 }
 
-// Add each agent's path to the map
-for (size_t agent_id = 0; agent_id < solution.size(); agent_id++) {
-    char icon = 'A' + agent_id;  // This will give 'A', 'B', 'C', ..., for agents
-    
-    for (size_t t = 0; t < solution[agent_id].size(); t++) {
-      auto& cell = solution[agent_id][t];
-      cell->icon = icon;
-      cell->icons.insert(icon);
-      cell->occupancy_map[t].push_back(agent_id);
+bool CBS::RectangleReasoning(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches) {
+  const Conflict& conflict = *node.conflict;
+  if (conflict.type != Conflict::VERTEX || map->GetMovementType() != MovementType::MANHATTAN) {
+    return false;
+  }
+
+  const int agent1 = conflict.agent1_id;
+  const int agent2 = conflict.agent2_id;
+  const AgentData& data1 = agents[agent1]->GetAgentData();
+  const AgentData& data2 = agents[agent2]->GetAgentData();
+
+  // Both agents must head the same way along both axes
+  auto sign = [](int value) { return (value > 0) - (value < 0); };
+  int row_dir = sign(data1.dest_row - data1.start_row);
+  int col_dir = sign(data1.dest_col - data1.start_col);
+  if (row_dir == 0 || col_dir == 0 ||
+      row_dir != sign(data2.dest_row - data2.start_row) ||
+      col_dir != sign(data2.dest_col - data2.start_col)) {
+    return false;
+  }
+
+  // Mirror the coordinates so that both agents move towards larger rows and columns
+  struct Point { int row, col; };
+  Point start[2] = {{data1.start_row * row_dir, data1.start_col * col_dir},
+                    {data2.start_row * row_dir, data2.start_col * col_dir}};
+  Point goal[2] = {{data1.dest_row * row_dir, data1.dest_col * col_dir},
+                   {data2.dest_row * row_dir, data2.dest_col * col_dir}};
+
+  // p is ahead in rows and crosses the rectangle horizontally, q is ahead in columns and crosses vertically
+  int p, q;
+  if (start[0].row >= start[1].row && start[1].col >= start[0].col) {
+    p = 0;
+    q = 1;
+  } else if (start[1].row >= start[0].row && start[0].col >= start[1].col) {
+    p = 1;
+    q = 0;
+  } else {
+    return false;
+  }
+
+  // Without waiting, both agents must reach every cell of the rectangle at the same time
+  if (start[p].row - start[q].row != start[q].col - start[p].col) {
+    return false;
+  }
+
+  Point corner_start = {start[p].row, start[q].col};
+  Point corner_goal = {std::min(goal[0].row, goal[1].row), std::min(goal[0].col, goal[1].col)};
+  if (corner_goal.row < corner_start.row || corner_goal.col < corner_start.col) {
+    return false;
+  }
+
+  // Each barrier is the far side of the rectangle, constrained at the agent's earliest arrival times
+  int ids[2] = {agent1, agent2};
+  std::array<Constraints, 2> candidate;
+  for (int r = corner_start.row; r <= corner_goal.row; r++) {
+    int time = (r - start[p].row) + (corner_goal.col - start[p].col);
+    candidate[p].addVertexConstraint({ids[p], r * row_dir, corner_goal.col * col_dir, time});
+  }
+  for (int c = corner_start.col; c <= corner_goal.col; c++) {
+    int time = (corner_goal.row - start[q].row) + (c - start[q].col);
+    candidate[q].addVertexConstraint({ids[q], corner_goal.row * row_dir, c * col_dir, time});
+  }
+
+  // Both children must rule out the current paths, or the split makes no progress
+  if (!PathViolates(node.solution[agent1], agent1, candidate[0]) ||
+      !PathViolates(node.solution[agent2], agent2, candidate[1])) {
+    return false;
+  }
+
+  split.type = Conflict::RECTANGLE;
+  split.row1 = corner_start.row * row_dir;
+  split.col1 = corner_start.col * col_dir;
+  split.row2 = corner_goal.row * row_dir;
+  split.col2 = corner_goal.col * col_dir;
+  branches = std::move(candidate);
+  return true;
+}
+
+bool CBS::PathViolates(const std::vector<std::shared_ptr<Cell>>& path, int agent_id, const Constraints& constraints) {
+  if (path.empty()) {
+    return false;
+  }
+
+  for (size_t t = 0; t < path.size(); t++) {
+    if (constraints.hasVertexConstraint(agent_id, path[t]->row, path[t]->col, t)) {
+      return true;
+    }
+    if (t > 0 && constraints.hasEdgeConstraint(agent_id, path[t - 1]->row, path[t - 1]->col,
+                                               path[t]->row, path[t]->col, t - 1)) {
+      return true;
     }
   }
-}
\ No newline at end of file
+
+  // The agent keeps waiting at its last cell
+  const auto& last = path.back();
+  return constraints.getLastVertexConstraintTime(agent_id, last->row, last->col) >= static_cast<int>(path.size());
+}
+
+int CBS::DistanceAvoiding(int from, int to, const std::unordered_set<int>& blocked) const {
+  std::vector<int> distance(map->GetCellCount(), Map::UNREACHABLE);
+  std::queue<int> frontier;
+  distance[from] = 0;
+  frontier.push(from);
+
+  while (!frontier.empty()) {
+    int index = frontier.front();
+    frontier.pop();
+    if (index == to) {
+      return distance[index];
+    }
+
+    int neighbors[8];
+    for (int k = 0, count = map->GetNeighborIds(index, neighbors); k < count; k++) {
+      int next = neighbors[k];
+      if (distance[next] == Map::UNREACHABLE && blocked.count(next) == 0) {
+        distance[next] = distance[index] + 1;
+        frontier.push(next);
+      }
+    }
+  }
+
+  return Map::UNREACHABLE;
+}
@@ -14,9 +14,14 @@
 #include <queue>
 #include <unordered_set>
 #include <unordered_map>
+#include <array>
+#include <cstdint>
 #include "Map.h"
 #include "Agent.h"
 #include "AStar.h"
+#include "Solver.h"
+#include "PathCache.h"
+#include "HierarchicalMap.h"
 
 /**
  * @brief Represents a vertex constraint in the CBS algorithm.
@@ -62,58 +67,146 @@ struct EdgeConstraint {
     bool operator==(const EdgeConstraint& other) const;
 };
 
-// Hash functions for constraints
+/**
+ * @brief Represents a range constraint in the CBS algorithm.
+ * 
+ * A range constraint prevents an agent from being at a specific position
+ * at any time step in [time_min, time_max]. Corridor reasoning uses it to
+ * rule out a whole family of symmetric vertex constraints at once.
+ */
+struct RangeConstraint {
+    int agent_id;  ///< ID of the constrained agent
+    int row;       ///< Row coordinate of the constraint
+    int col;       ///< Column coordinate of the constraint
+    int time_min;  ///< First constrained time step
+    int time_max;  ///< Last constrained time step
+
+    /**
+     * @brief Equality comparison operator.
+     * 
+     * @param other The constraint to compare with
+     * @return true if constraints are equal
+     */
+    bool operator==(const RangeConstraint& other) const;
+};
+
+/**
+ * @brief Folds one field into a running hash.
+ *
+ * @param seed Running hash
+ * @param value Field value
+ * @return Updated hash, to be passed through HashFinalize() when complete
+ */
+inline uint64_t HashCombine(uint64_t seed, int value) {
+  return (seed ^ static_cast<uint32_t>(value)) * 0x100000001b3ULL;
+}
+
+/**
+ * @brief Mixes a hash with the splitmix64 finalizer.
+ *
+ * Every input bit affects every output bit, so constraints that differ in
+ * one field get unrelated hashes and their sum is a usable set hash.
+ *
+ * @param x Hash to mix
+ * @return Mixed hash
+ */
+inline uint64_t HashFinalize(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Hash functions for constraints; each kind starts from its own seed
 namespace std {
     template <>
     struct hash<VertexConstraint> {
       size_t operator()(const VertexConstraint& c) const {
-        return hash<int>()(c.agent_id) ^ hash<int>()(c.row) ^ 
-                hash<int>()(c.col) ^ hash<int>()(c.time);
+        uint64_t h = HashCombine(0x76e7c3a1ULL, c.agent_id);
+        h = HashCombine(h, c.row);
+        h = HashCombine(h, c.col);
+        return HashFinalize(HashCombine(h, c.time));
       }
     };
 
     template <>
     struct hash<EdgeConstraint> {
       size_t operator()(const EdgeConstraint& c) const {
-        return hash<int>()(c.agent_id) ^ hash<int>()(c.row1) ^ 
-                hash<int>()(c.col1) ^ hash<int>()(c.row2) ^ 
-                hash<int>()(c.col2) ^ hash<int>()(c.time);
+        uint64_t h = HashCombine(0xed6e5b2fULL, c.agent_id);
+        h = HashCombine(h, c.row1);
+        h = HashCombine(h, c.col1);
+        h = HashCombine(h, c.row2);
+        h = HashCombine(h, c.col2);
+        return HashFinalize(HashCombine(h, c.time));
       }
     };
-}
 
-/**
- * @brief Represents a conflict between two agents.
- * 
- * A conflict can be either a vertex conflict (two agents at same position)
- * or an edge conflict (agents swapping positions).
- */
-struct Conflict {
-    enum Type { VERTEX, EDGE };  ///< Type of conflict
-    
-    Type type;      ///< Type of conflict (vertex or edge)
-    int agent1_id;  ///< ID of first agent in conflict
-    int agent2_id;  ///< ID of second agent in conflict
-    int row;        ///< Row coordinate (for vertex conflict)
-    int col;        ///< Column coordinate (for vertex conflict)
-    int row1;       ///< Starting row (for edge conflict)
-    int col1;       ///< Starting column (for edge conflict)
-    int row2;       ///< Ending row (for edge conflict)
-    int col2;       ///< Ending column (for edge conflict)
-    int time;       ///< Time step of the conflict
-};
+    template <>
+    struct hash<RangeConstraint> {
+      size_t operator()(const RangeConstraint& c) const {
+        uint64_t h = HashCombine(0x3a9e4d17ULL, c.agent_id);
+        h = HashCombine(h, c.row);
+        h = HashCombine(h, c.col);
+        h = HashCombine(h, c.time_min);
+        return HashFinalize(HashCombine(h, c.time_max));
+      }
+    };
+}
 
 /**
  * @brief Represents a set of constraints for an agent.
  * 
- * Contains both vertex and edge constraints that apply to an agent.
+ * Contains vertex, edge and range constraints that apply to an agent.
+ * Barrier constraints from rectangle reasoning are stored as the vertex
+ * constraints they imply.
+ * 
+ * The set keeps an order-independent hash: the sum of the hashes of its
+ * constraints, updated as constraints are added. Add constraints through
+ * the add methods or merge() so the hash stays in sync.
  */
 struct Constraints {
     std::unordered_set<VertexConstraint> vertex_constraints;  ///< Set of vertex constraints
     std::unordered_set<EdgeConstraint> edge_constraints;      ///< Set of edge constraints
+    std::unordered_set<RangeConstraint> range_constraints;    ///< Set of range constraints
+    uint64_t hash = 0;  ///< Sum of the hashes of all constraints
+    std::unordered_map<int, uint64_t> agent_hashes;  ///< Agent ID -> sum of the hashes of its constraints
 
     /**
-     * @brief Checks if a vertex constraint exists.
+     * @brief Adds a vertex constraint.
+     * 
+     * @param constraint Constraint to add
+     * @return true if the constraint was not in the set yet
+     */
+    bool addVertexConstraint(const VertexConstraint& constraint);
+
+    /**
+     * @brief Adds an edge constraint.
+     * 
+     * @param constraint Constraint to add
+     * @return true if the constraint was not in the set yet
+     */
+    bool addEdgeConstraint(const EdgeConstraint& constraint);
+
+    /**
+     * @brief Adds a range constraint.
+     * 
+     * @param constraint Constraint to add
+     * @return true if the constraint was not in the set yet
+     */
+    bool addRangeConstraint(const RangeConstraint& constraint);
+
+    /**
+     * @brief Gets the hash of the constraints on one agent.
+     * 
+     * The low-level search of an agent only reads that agent's constraints,
+     * so equal agent hashes mean equal search results.
+     * 
+     * @param agent_id Agent ID
+     * @return Sum of the hashes of the agent's constraints, 0 if it has none
+     */
+    uint64_t getAgentHash(int agent_id) const;
+
+    /**
+     * @brief Checks if a vertex or range constraint forbids a position.
      * 
      * @param agent_id Agent ID to check
      * @param row Row coordinate
@@ -135,6 +228,33 @@ struct Constraints {
      * @return true if constraint exists
      */
     bool hasEdgeConstraint(int agent_id, int row1, int col1, int row2, int col2, int time) const;
+
+    /**
+     * @brief Gets the last time step at which an agent may not be at a position.
+     * 
+     * An agent can only stop at its goal after this time.
+     * 
+     * @param agent_id Agent ID to check
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @return Last constrained time step, -1 if the position is never constrained
+     */
+    int getLastVertexConstraintTime(int agent_id, int row, int col) const;
+
+    /**
+     * @brief Gets the last time step touched by any constraint on an agent.
+     * 
+     * @param agent_id Agent ID to check
+     * @return Last constrained time step (edge constraints count their arrival), -1 if none
+     */
+    int getMaxConstraintTime(int agent_id) const;
+
+    /**
+     * @brief Adds all constraints of another set.
+     * 
+     * @param other Constraints to add
+     */
+    void merge(const Constraints& other);
 };
 
 /**
@@ -164,7 +284,7 @@ struct CBSNode {
  * The CBS class provides functionality for finding conflict-free paths
  * for multiple agents using the CBS algorithm.
  */
-class CBS {
+class CBS : public Solver {
 public:
     /**
      * @brief Constructs a new CBS solver.
@@ -176,58 +296,152 @@ public:
 
     /**
      * @brief Finds conflict-free paths for all agents.
+     *
+     * @return true if a conflict-free solution was found
      */
-    void PathFind();
+    bool PathFind() override;
 
-private:
-    std::shared_ptr<Map> map;  ///< Shared pointer to the map
-    std::vector<std::shared_ptr<Agent>>& agents;  ///< Vector of agents
-    
     /**
-     * @brief Finds conflicts in the current solution.
+     * @brief Chooses whether PathFind() publishes its solution.
      * 
-     * @param solution Current solution to check
-     * @return Pointer to first conflict found, or nullptr if no conflicts
+     * Engines that run CBS on a subset of the agents turn publishing off and
+     * read GetSolution() instead. CBS then writes to no shared state, so
+     * several instances can run on different threads.
+     * 
+     * @param publish true to update the map and the agents (the default)
      */
-    std::shared_ptr<Conflict> FindConflict(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
-    
+    void SetPublishSolution(bool publish);
+
     /**
-     * @brief Checks for conflicts between two agents' paths.
+     * @brief Resolves conflicts only within the next time steps.
      * 
-     * @param path1 First agent's path
-     * @param path2 Second agent's path
-     * @param conflict_time Output parameter for time of conflict
-     * @param conflict Output parameter for conflict details
-     * @return true if a conflict exists
+     * Used for rolling-horizon planning: conflicts after the window are
+     * ignored and the low-level search stops checking constraints there,
+     * so the work per call is bounded by the window, not the path length.
+     * Symmetry reasoning is turned off while a window is set.
+     * 
+     * @param window Number of time steps to keep conflict-free, 0 for full paths
      */
-    bool HasConflict(const std::vector<std::shared_ptr<Cell>>& path1, 
-                    const std::vector<std::shared_ptr<Cell>>& path2, 
-                    int& conflict_time,
-                    std::shared_ptr<Conflict>& conflict);
-    
+    void SetWindow(int window);
+
+    /**
+     * @brief Sets how many nodes are expanded before the search gives up.
+     * 
+     * @param iterations Node expansion limit (default: 100)
+     */
+    void SetMaxIterations(int iterations);
+
+    /**
+     * @brief Sets how many low-level paths are memoized during a search.
+     * 
+     * @param size Cache capacity in paths, 0 to disable (default: 4096)
+     */
+    void SetPathCacheSize(size_t size);
+
+    /**
+     * @brief Plans the root paths over an HPA* abstraction instead of with A*.
+     * 
+     * Only the root node uses it; agents that get constraints are replanned
+     * with A* as usual. Root paths may be a few moves longer than optimal,
+     * so the solution is no longer guaranteed to be optimal. Ignored while
+     * a window is set.
+     * 
+     * @param _hierarchy Abstraction of the map, nullptr to plan roots with A*
+     */
+    void SetHierarchy(std::shared_ptr<const HierarchicalMap> _hierarchy);
+
+    /**
+     * @brief Gets the paths found by the last successful PathFind().
+     * 
+     * @return One path per agent, indexed like the agents vector
+     */
+    const std::vector<std::vector<std::shared_ptr<Cell>>>& GetSolution() const;
+
+private:
+    bool publish_solution = true;  ///< Whether PathFind() updates the map and the agents
+    int window = 0;  ///< Time steps kept conflict-free, 0 for full paths
+    int max_iterations = 100;  ///< Node expansion limit
+    size_t path_cache_size = 4096;  ///< Capacity of the low-level path cache
+    std::shared_ptr<const HierarchicalMap> hierarchy;  ///< Abstraction used for root paths, if any
+    std::vector<std::vector<std::shared_ptr<Cell>>> solution;  ///< Paths of the last solution
+
     /**
      * @brief Finds a path for a single agent with constraints.
      * 
+     * Returns the cached result if the agent was already planned under the
+     * same constraints, and caches the result of a new search otherwise.
+     * 
+     * @param astar Low-level search to run on a cache miss
+     * @param cache Paths found so far in this search
      * @param agent_id ID of the agent
      * @param constraints Set of constraints to satisfy
-     * @return Vector of cells representing the path
+     * @return Vector of cells representing the path, empty if none exists
      */
-    std::vector<std::shared_ptr<Cell>> FindPath(int agent_id, const Constraints& constraints);
-    
+    std::vector<std::shared_ptr<Cell>> FindPath(AStar& astar, PathCache& cache, int agent_id, const Constraints& constraints);
+
     /**
-     * @brief Calculates the total cost of all paths.
+     * @brief Computes the constraints added to each child of a node.
+     * 
+     * Tries corridor and rectangle reasoning first and falls back to a
+     * single vertex or edge constraint per child. The node's conflict is
+     * left as found; the kind of split chosen is reported in split.
      * 
-     * @param solution Current solution to evaluate
-     * @return Total cost of all paths
+     * @param node Node whose conflict is split
+     * @param split Output: the node's conflict, classified as a corridor or rectangle conflict if one applies
+     * @param branches Output constraints for agent1 (index 0) and agent2 (index 1)
      */
-    int CalculateSolutionCost(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
-    
+    void GetBranchConstraints(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches);
+
+    /**
+     * @brief Resolves a conflict inside a corridor of degree-2 cells with range constraints.
+     * 
+     * One agent may not reach the far end of the corridor before the other
+     * could have passed through it, unless it takes a bypass. Arrival times
+     * are bounded from below by breadth-first distances, which keeps the
+     * split complete.
+     * 
+     * @param node Node whose conflict is split
+     * @param split Output: set to the corridor conflict on success, untouched otherwise
+     * @param branches Output constraints for both children
+     * @return true if the conflict is a corridor conflict that both branches resolve
+     */
+    bool CorridorReasoning(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches);
+
+    /**
+     * @brief Resolves a conflict between two Manhattan-optimal crossing paths with barrier constraints.
+     * 
+     * Only applies to MANHATTAN maps: any two monotone paths crossing the
+     * rectangle in perpendicular directions meet at the same time, so one
+     * agent must leave its optimal arrival times on its barrier.
+     * 
+     * @param node Node whose conflict is split
+     * @param split Output: set to the rectangle conflict on success, untouched otherwise
+     * @param branches Output constraints for both children
+     * @return true if the conflict is a rectangle conflict that both branches resolve
+     */
+    bool RectangleReasoning(const CBSNode& node, Conflict& split, std::array<Constraints, 2>& branches);
+
+    /**
+     * @brief Checks if a path breaks any of the given constraints.
+     * 
+     * The agent is assumed to wait at the last cell once the path ends.
+     * 
+     * @param path Path to check
+     * @param agent_id Agent following the path
+     * @param constraints Constraints to check against
+     * @return true if some constraint is violated
+     */
+    static bool PathViolates(const std::vector<std::shared_ptr<Cell>>& path, int agent_id, const Constraints& constraints);
+
     /**
-     * @brief Updates the map cells with agents' paths.
+     * @brief Counts the moves between two cells without entering blocked cells.
      * 
-     * @param solution Current solution to visualize
+     * @param from Flat index of the first cell
+     * @param to Flat index of the second cell
+     * @param blocked Flat indices that may not be entered
+     * @return Move count, Map::UNREACHABLE if no such route exists
      */
-    void UpdateMapWithSolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+    int DistanceAvoiding(int from, int to, const std::unordered_set<int>& blocked) const;
 };
 
 #endif // CBS_H
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "CommandLine.h"
+#include "SolverService.h"
+#include "SolutionWriter.h"
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+// Helper function to print usage information
+void PrintUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]\n"
+              << "Options:\n"
+              << "  -a, --agents <number>    Number of agents (default: 1)\n"
+              << "  -m, --map <name>         Map name (default: maze-32-32-4)\n"
+              << "  -f, --folder <name>      Scenario folder (default: maze-32-32-2)\n"
+              << "  -s, --scenario <name>    Scenario name (default: maze-32-32-2-even-1)\n"
+              << "  -e, --engine <name>      Engine: cbs, pp, pbs, lns, pibt, lacam, id (default: cbs)\n"
+              << "  -t, --time-limit <sec>   Deadline of every engine; lns uses all of it (default: 1)\n"
+              << "  -w, --window <steps>     Rolling-horizon CBS with this conflict window (default: 0, off)\n"
+              << "  -r, --replan <steps>     Steps executed between rolling-horizon replans (default: 5)\n"
+              << "  -c, --cycles <number>    Maximum rolling-horizon cycles (default: 100)\n"
+              << "  -i, --iterations <number> CBS node expansion limit, also per id group (default: 100)\n"
+              << "  -p, --path-cache <paths> CBS low-level path cache size, 0 to disable (default: 4096)\n"
+              << "  -l, --landmarks <number> Landmarks for the differential heuristic, 0 to disable (default: 0)\n"
+              << "      --hpa <cells>        Plan CBS root paths with HPA* clusters of this size (default: 0, off)\n"
+              << "  -q, --quiet              Do not print the agents and the maps\n"
+              << "      --preprocess         Write the map and its agents' distance tables to <map>.mapbin and exit\n"
+              << "      --batch              Solve every scenario of the folder with growing agent counts, from -a on\n"
+              << "      --step <number>      Agent count increase between batch instances (default: 1)\n"
+              << "      --timeout <sec>      Deadline of each batch instance (default: 60)\n"
+              << "  -j, --jobs <number>      Scenarios solved in parallel in a batch, 0 for all cores (default: 1)\n"
+              << "      --csv <file>         Write the batch results as CSV\n"
+              << "      --json <file>        Write the batch results as JSON\n"
+              << "      --stats <file>       Write the solver's counters and phase times as JSON, - for stdout\n"
+              << "      --solution <file>    Write the paths of the solution to this file\n"
+              << "      --solution-format <f> text (one line of cells per agent) or binary (default: text)\n"
+              << "      --serve              Answer solve requests on stdin and stdout, keeping maps loaded\n"
+              << "      --socket <path>      Answer solve requests on a Unix domain socket instead of stdin\n"
+              << "  -h, --help               Show this help message\n";
+}
+
+// Helper function to parse command line arguments
+Config ParseArguments(int argc, char* argv[]) {
+    Config config;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage(argv[0]);
+            exit(0);
+        }
+        else if (arg == "-a" || arg == "--agents") {
+            if (i + 1 < argc) {
+                try {
+                    config.agents_count = std::stoi(argv[++i]);
+                    if (config.agents_count <= 0) {
+                        throw std::invalid_argument("Agent count must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid agent count. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-m" || arg == "--map") {
+            if (i + 1 < argc) {
+                config.map_name = argv[++i];
+            }
+        }
+        else if (arg == "-f" || arg == "--folder") {
+            if (i + 1 < argc) {
+                config.scenario_folder = argv[++i];
+            }
+        }
+        else if (arg == "-s" || arg == "--scenario") {
+            if (i + 1 < argc) {
+                config.scenario_name = argv[++i];
+            }
+        }
+        else if (arg == "-e" || arg == "--engine") {
+            if (i + 1 < argc) {
+                config.engine = argv[++i];
+                try {
+                    Manager::ParseSolverType(config.engine);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-t" || arg == "--time-limit") {
+            if (i + 1 < argc) {
+                try {
+                    config.time_limit = std::stod(argv[++i]);
+                    if (config.time_limit <= 0) {
+                        throw std::invalid_argument("Time limit must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid time limit. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-w" || arg == "--window") {
+            if (i + 1 < argc) {
+                try {
+                    config.window = std::stoi(argv[++i]);
+                    if (config.window < 0) {
+                        throw std::invalid_argument("Window must not be negative");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid window. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-r" || arg == "--replan") {
+            if (i + 1 < argc) {
+                try {
+                    config.replan_period = std::stoi(argv[++i]);
+                    if (config.replan_period <= 0) {
+                        throw std::invalid_argument("Replan period must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid replan period. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-c" || arg == "--cycles") {
+            if (i + 1 < argc) {
+                try {
+                    config.cycles = std::stoi(argv[++i]);
+                    if (config.cycles <= 0) {
+                        throw std::invalid_argument("Cycle count must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid cycle count. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-i" || arg == "--iterations") {
+            if (i + 1 < argc) {
+                try {
+                    config.max_iterations = std::stoi(argv[++i]);
+                    if (config.max_iterations <= 0) {
+                        throw std::invalid_argument("Iteration limit must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid iteration limit. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-q" || arg == "--quiet") {
+            config.quiet = true;
+        }
+        else if (arg == "-l" || arg == "--landmarks") {
+            if (i + 1 < argc) {
+                try {
+                    config.landmarks = std::stoi(argv[++i]);
+                    if (config.landmarks < 0) {
+                        throw std::invalid_argument("Landmark count must not be negative");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid landmark count. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--hpa") {
+            if (i + 1 < argc) {
+                try {
+                    config.cluster_size = std::stoi(argv[++i]);
+                    if (config.cluster_size < 0 || config.cluster_size == 1) {
+                        throw std::invalid_argument("Cluster size must be 0 or at least 2");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid cluster size. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--preprocess") {
+            config.preprocess = true;
+        }
+        else if (arg == "--batch") {
+            config.batch = true;
+        }
+        else if (arg == "--step") {
+            if (i + 1 < argc) {
+                try {
+                    config.agent_step = std::stoi(argv[++i]);
+                    if (config.agent_step <= 0) {
+                        throw std::invalid_argument("Step must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid agent step. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--timeout") {
+            if (i + 1 < argc) {
+                try {
+                    config.instance_time_limit = std::stod(argv[++i]);
+                    if (config.instance_time_limit <= 0) {
+                        throw std::invalid_argument("Timeout must be positive");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid timeout. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc) {
+                try {
+                    config.jobs = std::stoi(argv[++i]);
+                    if (config.jobs < 0) {
+                        throw std::invalid_argument("Job count must not be negative");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid job count. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--stats") {
+            if (i + 1 < argc) {
+                config.stats_path = argv[++i];
+            }
+        }
+        else if (arg == "--csv") {
+            if (i + 1 < argc) {
+                config.csv_path = argv[++i];
+            }
+        }
+        else if (arg == "--solution") {
+            if (i + 1 < argc) {
+                config.solution_path = argv[++i];
+            }
+        }
+        else if (arg == "--solution-format") {
+            if (i + 1 < argc) {
+                config.solution_format = argv[++i];
+                try {
+                    SolutionWriter::ParseSolutionFormat(config.solution_format);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--serve") {
+            config.serve = true;
+        }
+        else if (arg == "--socket") {
+            if (i + 1 < argc) {
+                config.socket_path = argv[++i];
+                config.serve = true;
+            }
+        }
+        else if (arg == "--json") {
+            if (i + 1 < argc) {
+                config.json_path = argv[++i];
+            }
+        }
+        else if (arg == "-p" || arg == "--path-cache") {
+            if (i + 1 < argc) {
+                try {
+                    config.path_cache_size = std::stoi(argv[++i]);
+                    if (config.path_cache_size < 0) {
+                        throw std::invalid_argument("Path cache size must not be negative");
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid path cache size. " << e.what() << std::endl;
+                    exit(1);
+                }
+            }
+        }
+    }
+    
+    return config;
+}
+
+// Helper function to validate file existence
+bool ValidateFiles(const Config& config) {
+    namespace fs = std::filesystem;
+    
+    // Check map file
+    std::string map_path = "../tests/maps/" + config.map_name + ".map";
+    if (!fs::exists(map_path)) {
+        std::cerr << "Error: Map file not found: " << map_path << std::endl;
+        return false;
+    }
+    
+    // The service gets its agents from the requests
+    if (config.serve) {
+        return true;
+    }
+    
+    // A batch reads every scenario of the folder
+    if (config.batch) {
+        std::string folder_path = "../tests/scenarios/" + config.scenario_folder;
+        if (!fs::is_directory(folder_path)) {
+            std::cerr << "Error: Scenario folder not found: " << folder_path << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    // Check scenario file
+    std::string scenario_path = "../tests/scenarios/" + config.scenario_folder + "/" + config.scenario_name + ".scen";
+    if (!fs::exists(scenario_path)) {
+        std::cerr << "Error: Scenario file not found: " << scenario_path << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+// Helper function to write the preprocessed map
+bool RunPreprocess(Manager& manager, const Config& config) {
+    try {
+        manager.InitializeMap(config.map_name);
+        if (config.landmarks > 0) {
+            manager.SetLandmarkCount(config.landmarks);
+        }
+        manager.SetQuiet(true);
+        manager.InitializeScenario(config.map_name, config.scenario_folder,
+                                 config.scenario_name, config.agents_count);
+        return manager.PreprocessMap();
+    } catch (const std::exception& e) {
+        std::cerr << "Error during preprocessing: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Helper function to run a benchmark batch
+bool RunBatch(Manager& manager, const Config& config) {
+    std::vector<InstanceResult> results;
+    try {
+        manager.InitializeMap(config.map_name);
+        if (config.landmarks > 0) {
+            manager.SetLandmarkCount(config.landmarks);
+        }
+        manager.SetSolverType(Manager::ParseSolverType(config.engine));
+        manager.SetTimeLimit(config.time_limit);
+        manager.SetMaxIterations(config.max_iterations);
+        manager.SetPathCacheSize(config.path_cache_size);
+        manager.SetClusterSize(config.cluster_size);
+        results = manager.RunBatch(config.scenario_folder, config.agents_count, config.agent_step,
+                                   config.instance_time_limit, config.jobs);
+    } catch (const std::exception& e) {
+        std::cerr << "Error during batch run: " << e.what() << std::endl;
+        return false;
+    }
+    
+    bool written = true;
+    if (!config.csv_path.empty()) {
+        written = BatchRunner::WriteCsv(config.csv_path, results) && written;
+    }
+    if (!config.json_path.empty()) {
+        written = BatchRunner::WriteJson(config.json_path, results) && written;
+    }
+    return written;
+}
+
+// Helper function to run the solver service
+bool RunService(const Config& config) {
+    SolverService service([&config](Manager& manager) {
+        if (config.landmarks > 0) {
+            manager.SetLandmarkCount(config.landmarks);
+        }
+        manager.SetSolverType(Manager::ParseSolverType(config.engine));
+        manager.SetTimeLimit(config.time_limit);
+        manager.SetMaxIterations(config.max_iterations);
+        manager.SetPathCacheSize(config.path_cache_size);
+        manager.SetClusterSize(config.cluster_size);
+    }, config.jobs);
+    
+    // Warm the map of the options before the first request
+    try {
+        service.GetManager(config.map_name);
+    } catch (const std::exception& e) {
+        std::cerr << "Error during service start: " << e.what() << std::endl;
+        return false;
+    }
+    
+    if (!config.socket_path.empty()) {
+        return service.ServeSocket(config.socket_path);
+    }
+    service.Serve(STDIN_FILENO, STDOUT_FILENO);
+    return true;
+}
+
+// Helper function to run pathfinding
+bool RunPathfinding(Manager& manager, const Config& config) {
+    try {
+        // Initialize the map
+        manager.InitializeMap(config.map_name);
+        
+        // Print initial map
+        if (!config.quiet) {
+            std::cout << "Initial Map:" << std::endl;
+            manager.PrintMap();
+            std::cout << "==========================================================\n";
+        }
+        
+        // Initialize the scenario
+        manager.SetQuiet(config.quiet);
+        manager.InitializeScenario(config.map_name, config.scenario_folder, 
+                                 config.scenario_name, config.agents_count);
+        
+        // Start pathfinding
+        manager.SetSolverType(Manager::ParseSolverType(config.engine));
+        manager.SetTimeLimit(config.time_limit);
+        manager.SetMaxIterations(config.max_iterations);
+        manager.SetPathCacheSize(config.path_cache_size);
+        manager.SetClusterSize(config.cluster_size);
+        if (config.landmarks > 0) {
+            manager.SetLandmarkCount(config.landmarks);
+        }
+        if (config.window > 0) {
+            manager.RunRollingHorizon(config.window, config.replan_period, config.cycles);
+        } else {
+            manager.StartPathfind();
+        }
+        
+        // Print final map
+        if (!config.quiet) {
+            std::cout << "\nFinal Map:" << std::endl;
+            manager.PrintMap();
+        }
+        
+        // Write the solver statistics
+        if (!config.stats_path.empty() && manager.GetSolver()) {
+            std::string json = manager.GetSolver()->GetStats().ToJson();
+            if (config.stats_path == "-") {
+                std::cout << json << std::endl;
+            } else {
+                std::ofstream stats_file(config.stats_path);
+                if (!stats_file.is_open()) {
+                    std::cerr << "Error: Cannot write " << config.stats_path << std::endl;
+                    return false;
+                }
+                stats_file << json << "\n";
+            }
+        }
+        
+        // Stream the paths to the solution file
+        if (!config.solution_path.empty()) {
+            const auto& agents = manager.GetAgents();
+            for (const auto& agent : agents) {
+                if (agent->GetPath().empty()) {
+                    std::cerr << "Error: No solution to write, agent " << agent->GetAgentData().agent_id
+                              << " has no path" << std::endl;
+                    return false;
+                }
+            }
+            SolutionWriter writer(config.solution_path,
+                                  SolutionWriter::ParseSolutionFormat(config.solution_format),
+                                  *manager.GetMap(), static_cast<int>(agents.size()));
+            for (const auto& agent : agents) {
+                writer.WriteAgent(agent->GetAgentData().agent_id, agent->GetPath());
+            }
+            if (!writer.Close()) {
+                std::cerr << "Error: Cannot write " << config.solution_path << std::endl;
+                return false;
+            }
+        }
+        
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error during pathfinding: " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file CommandLine.h
+ * @brief Declares the command-line front end shared by the solver and the visualizer.
+ *
+ * Both executables accept the same options and run the same steps; the
+ * visualizer only adds the windows at the end.
+ */
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <string>
+#include "Manager.h"
+
+/**
+ * @brief Options of a run, with their default values.
+ */
+struct Config {
+    std::string map_name = "maze-32-32-4";
+    std::string scenario_folder = "maze-32-32-2";
+    std::string scenario_name = "maze-32-32-2-even-1";
+    int agents_count = 1;
+    std::string engine = "cbs";
+    double time_limit = 1.0;
+    int window = 0;
+    int replan_period = 5;
+    int cycles = 100;
+    int max_iterations = 0;
+    int path_cache_size = -1;
+    bool quiet = false;
+    bool preprocess = false;
+    int landmarks = 0;
+    int cluster_size = 0;
+    bool batch = false;
+    int agent_step = 1;
+    double instance_time_limit = 60.0;
+    int jobs = 1;
+    std::string stats_path;
+    std::string solution_path;
+    std::string solution_format = "text";
+    std::string csv_path;
+    std::string json_path;
+    bool serve = false;
+    std::string socket_path;
+};
+
+/**
+ * @brief Prints the available options.
+ *
+ * @param program_name Name the program was started with
+ */
+void PrintUsage(const char* program_name);
+
+/**
+ * @brief Parses the command line, exiting with an error message on invalid values.
+ *
+ * @param argc Argument count
+ * @param argv Arguments
+ * @return The options, defaults where not given
+ */
+Config ParseArguments(int argc, char* argv[]);
+
+/**
+ * @brief Checks that the map and scenario files of a run exist.
+ *
+ * @param config Options of the run
+ * @return false (after printing the missing path) if a file is missing
+ */
+bool ValidateFiles(const Config& config);
+
+/**
+ * @brief Loads the map and scenario and writes the preprocessed map.
+ *
+ * @param manager Manager to load into
+ * @param config Options of the run
+ * @return true if the file was written
+ */
+bool RunPreprocess(Manager& manager, const Config& config);
+
+/**
+ * @brief Loads the map once and benchmarks the selected engine on every scenario of the folder.
+ *
+ * Writes the results to the CSV and JSON files given in the options.
+ *
+ * @param manager Manager to load into
+ * @param config Options of the run
+ * @return false if loading failed or a result file could not be written
+ */
+bool RunBatch(Manager& manager, const Config& config);
+
+/**
+ * @brief Loads the map and scenario, plans with the selected engine and prints the result.
+ *
+ * @param manager Manager to load into; holds the solution afterwards
+ * @param config Options of the run
+ * @return false if loading failed
+ */
+bool RunPathfinding(Manager& manager, const Config& config);
+
+/**
+ * @brief Runs the solver service until its input ends.
+ *
+ * Answers requests on standard input and output, or on a Unix domain
+ * socket if one is given. The map of the options is loaded right away;
+ * other maps are loaded by the first request on them. Every map gets the
+ * engine settings of the options.
+ *
+ * @param config Options of the run
+ * @return false if the map or the socket could not be set up
+ */
+bool RunService(const Config& config);
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,84 @@
+#include "DistanceTable.h"
+#include <algorithm>
+#include <cstdlib>
+
+DistanceTable::DistanceTable(std::shared_ptr<Map> _map, int goal_index, int target_index)
+  : map(std::move(_map)), full_table(map->GetCachedDistanceTable(goal_index)) {
+  if (full_table) {
+    return;
+  }
+
+  int cell_count = map->GetCellCount();
+  if (target_index >= 0 && target_index < cell_count) {
+    target_row = map->GetRow(target_index);
+    target_col = map->GetCol(target_index);
+    guided = true;
+  }
+  distances.reset(new uint16_t[cell_count]);
+  reached.assign((cell_count + 63) / 64, 0);
+  closed.assign((cell_count + 63) / 64, 0);
+  if (map->IsPassable(goal_index)) {
+    Open(goal_index, 0);
+  }
+}
+
+int DistanceTable::Bound(int index) const {
+  if (!guided) {
+    return 0;
+  }
+  int row = map->GetRow(index);
+  int drow = std::abs(row - target_row);
+  int dcol = std::abs(index - row * map->GetWidth() - target_col);
+  return map->GetMovementType() == MovementType::OCTILE ? std::max(drow, dcol) : drow + dcol;
+}
+
+void DistanceTable::Open(int index, int distance) {
+  if (distance < FAR) {
+    distances[index] = distance;
+  } else {
+    distances[index] = FAR;
+    far_distances[index] = distance;
+  }
+  reached[index >> 6] |= uint64_t{1} << (index & 63);
+
+  buckets[(distance + Bound(index)) % 3].push_back(index);
+}
+
+int DistanceTable::Expand(int index) {
+  // A* backwards from the goal (moves are symmetric). The bound is consistent,
+  // so a cell's move count is final the first time it leaves the open list.
+  // A move adds 1 to the move count and changes the bound by at most 1, so
+  // open cells have the lowest priority or one of the next two.
+  while (!(closed[index >> 6] >> (index & 63) & 1u)) {
+    int skipped = 0;
+    while (buckets[priority % 3].empty() && skipped < 3) {
+      priority++;
+      skipped++;
+    }
+    std::vector<int>& bucket = buckets[priority % 3];
+    if (bucket.empty()) {
+      return Map::UNREACHABLE;
+    }
+
+    // Among equal priorities the cell queued last is the one farthest from the goal
+    int current = bucket.back();
+    bucket.pop_back();
+    uint64_t& word = closed[current >> 6];
+    uint64_t bit = uint64_t{1} << (current & 63);
+    if (word & bit) {
+      continue;  // Older entry with a higher move count; the cell was already expanded
+    }
+    word |= bit;
+
+    int next_distance = Lookup(current) + 1;
+    int neighbors[8];
+    for (int k = 0, count = map->GetNeighborIds(current, neighbors); k < count; ++k) {
+      // Unreached cells look up as UNREACHABLE, and settled ones are never farther
+      if (next_distance < Lookup(neighbors[k])) {
+        Open(neighbors[k], next_distance);
+      }
+    }
+  }
+
+  return Lookup(index);
+}
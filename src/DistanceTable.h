@@ -0,0 +1,110 @@
+/**
+ * @file DistanceTable.h
+ * @brief Defines a lazily evaluated distance-to-goal table.
+ *
+ * Engines that plan thousands of agents only ever look at cells near each
+ * agent's route. Instead of running a full breadth-first search per goal,
+ * this table runs a resumable reverse A* search: it expands from the goal
+ * toward the cell asked for first, usually the agent's start, and resumes
+ * whenever a cell that is not settled yet is requested. On open maps this
+ * settles a band around the route instead of a disk around the goal.
+ */
+
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "Map.h"
+
+/**
+ * @brief Number of moves from any cell to one goal, computed on demand.
+ *
+ * A table is owned by a single solver and is not thread-safe. If the map
+ * already holds a full table for the goal, that table is used directly.
+ *
+ * Engines keep one table per goal, so distances are stored in 16 bits;
+ * the few cells farther than that fits are kept in a side map. Only the
+ * entries the search reaches are ever written, so untouched parts of the
+ * table cost no memory.
+ */
+class DistanceTable {
+public:
+    /**
+     * @brief Constructs a table for a goal.
+     *
+     * @param _map Shared pointer to the map
+     * @param goal_index Flat index of the goal cell
+     * @param target_index Cell the search heads for, usually the agent's start; -1 to grow evenly around the goal
+     */
+    DistanceTable(std::shared_ptr<Map> _map, int goal_index, int target_index = -1);
+
+    /**
+     * @brief Gets the number of moves from a cell to the goal.
+     *
+     * @param index Flat cell index
+     * @return Move count, Map::UNREACHABLE if the goal cannot be reached
+     */
+    int Get(int index) {
+        if (full_table) return full_table[index];
+        if (closed[index >> 6] >> (index & 63) & 1u) return Lookup(index);
+        return Expand(index);
+    }
+
+private:
+    /// Entry of a cell whose distance is in far_distances
+    static constexpr uint16_t FAR = UINT16_MAX;
+
+    std::shared_ptr<Map> map;                              ///< Shared pointer to the map
+    std::shared_ptr<const int[]> full_table;               ///< Precomputed table, if the map had one
+    int target_row = 0;                                    ///< Row the heuristic measures to
+    int target_col = 0;                                    ///< Column the heuristic measures to
+    bool guided = false;                                   ///< Whether the search heads for a target
+    std::unique_ptr<uint16_t[]> distances;                 ///< Best move count found so far, or FAR; left uninitialized until reached
+    std::unordered_map<int, int> far_distances;            ///< Cell -> move count of the cells marked FAR
+    std::vector<uint64_t> reached;                         ///< Bit set of the cells with a move count
+    std::vector<uint64_t> closed;                          ///< Bit set of the cells whose move count is final
+    std::vector<int> buckets[3];                           ///< Open cells by priority modulo 3, last in first out
+    int priority = 0;                                      ///< Lowest priority of an open cell
+
+    /**
+     * @brief Gets the stored move count of a cell.
+     *
+     * @param index Flat cell index
+     * @return Move count, Map::UNREACHABLE if the search has not reached the cell
+     */
+    int Lookup(int index) const {
+        if (!(reached[index >> 6] >> (index & 63) & 1u)) return Map::UNREACHABLE;
+        uint16_t distance = distances[index];
+        return distance != FAR ? distance : far_distances.at(index);
+    }
+
+    /**
+     * @brief Gets a lower bound on the moves between a cell and the target.
+     *
+     * Every move changes the row and the column by at most one, so this is
+     * the Chebyshev distance on 8-connected maps and the Manhattan distance
+     * on 4-connected ones; 0 if the search has no target.
+     */
+    int Bound(int index) const;
+
+    /**
+     * @brief Lowers the move count of a cell and queues it.
+     *
+     * @param index Flat cell index
+     * @param distance New move count
+     */
+    void Open(int index, int distance);
+
+    /**
+     * @brief Continues the search until a cell is settled or the search is exhausted.
+     *
+     * @param index Flat cell index to settle
+     * @return Distance of the cell
+     */
+    int Expand(int index);
+};
+
+#endif // DISTANCE_TABLE_H
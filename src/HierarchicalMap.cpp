@@ -0,0 +1,281 @@
+#include "HierarchicalMap.h"
+#include <algorithm>
+#include <functional>
+
+HierarchicalMap::HierarchicalMap(std::shared_ptr<const Map> _map, int _cluster_size)
+  : map(std::move(_map)), cluster_size(std::max(2, _cluster_size)) {
+  int width = map->GetWidth();
+  int height = map->GetHeight();
+  cluster_columns = (width + cluster_size - 1) / cluster_size;
+  int cluster_rows = (height + cluster_size - 1) / cluster_size;
+  cluster_entrances.resize(cluster_columns * cluster_rows);
+
+  // Borders between clusters side by side
+  for (int row = 0; row < height; row += cluster_size) {
+    for (int col = cluster_size - 1; col + 1 < width; col += cluster_size) {
+      AddBorderEntrances(map->GetIndex(row, col), width, 1, std::min(cluster_size, height - row));
+    }
+  }
+
+  // Borders between clusters one above the other
+  for (int row = cluster_size - 1; row + 1 < height; row += cluster_size) {
+    for (int col = 0; col < width; col += cluster_size) {
+      AddBorderEntrances(map->GetIndex(row, col), 1, width, std::min(cluster_size, width - col));
+    }
+  }
+
+  for (int cluster = 0; cluster < static_cast<int>(cluster_entrances.size()); ++cluster) {
+    ConnectCluster(cluster);
+  }
+}
+
+int HierarchicalMap::GetCluster(int index) const {
+  return map->GetRow(index) / cluster_size * cluster_columns + map->GetCol(index) / cluster_size;
+}
+
+int HierarchicalMap::GetLocalIndex(int index) const {
+  return map->GetRow(index) % cluster_size * cluster_size + map->GetCol(index) % cluster_size;
+}
+
+int HierarchicalMap::GridDistance(int from, int to) const {
+  int drow = std::abs(map->GetRow(from) - map->GetRow(to));
+  int dcol = std::abs(map->GetCol(from) - map->GetCol(to));
+  return map->GetMovementType() == MovementType::OCTILE ? std::max(drow, dcol) : drow + dcol;
+}
+
+int HierarchicalMap::AddEntrance(int index) {
+  auto it = cell_nodes.find(index);
+  if (it != cell_nodes.end()) {
+    return it->second;
+  }
+
+  int node = static_cast<int>(node_cells.size());
+  node_cells.push_back(index);
+  cell_nodes.emplace(index, node);
+  edges.emplace_back();
+  cluster_entrances[GetCluster(index)].push_back(node);
+  return node;
+}
+
+void HierarchicalMap::AddBorderEntrances(int first, int step, int across, int length) {
+  // Split the border into maximal segments that are free on both sides
+  int segment_start = -1;
+  for (int i = 0; i <= length; ++i) {
+    int near = first + i * step;
+    bool open = i < length && map->IsPassable(near) && map->IsPassable(near + across);
+    if (open && segment_start < 0) {
+      segment_start = i;
+    } else if (!open && segment_start >= 0) {
+      int segment_end = i - 1;
+      std::vector<int> positions = {(segment_start + segment_end) / 2};
+      if (segment_end - segment_start + 1 >= WIDE_ENTRANCE) {
+        positions = {segment_start, segment_end};
+      }
+
+      for (int position : positions) {
+        int near_node = AddEntrance(first + position * step);
+        int far_node = AddEntrance(first + position * step + across);
+        edges[near_node].push_back({far_node, 1});
+        edges[far_node].push_back({near_node, 1});
+      }
+      segment_start = -1;
+    }
+  }
+}
+
+void HierarchicalMap::ConnectCluster(int cluster) {
+  const std::vector<int>& entrances = cluster_entrances[cluster];
+  ClusterGraph graph;
+  BuildClusterGraph(cluster, graph);
+  std::vector<int> distances;
+  for (int from : entrances) {
+    ClusterSearch(graph, node_cells[from], distances);
+    for (int to : entrances) {
+      int distance = distances[GetLocalIndex(node_cells[to])];
+      if (to != from && distance != Map::UNREACHABLE) {
+        edges[from].push_back({to, distance});
+      }
+    }
+  }
+}
+
+void HierarchicalMap::BuildClusterGraph(int cluster, ClusterGraph& graph) const {
+  graph.row = cluster / cluster_columns * cluster_size;
+  graph.col = cluster % cluster_columns * cluster_size;
+  int row_end = std::min(graph.row + cluster_size, map->GetHeight());
+  int col_end = std::min(graph.col + cluster_size, map->GetWidth());
+
+  graph.first.assign(cluster_size * cluster_size + 1, 0);
+  graph.neighbors.clear();
+  for (int local = 0; local < cluster_size * cluster_size; ++local) {
+    graph.first[local] = static_cast<int>(graph.neighbors.size());
+    int row = graph.row + local / cluster_size;
+    int col = graph.col + local % cluster_size;
+    if (row >= row_end || col >= col_end) {
+      continue;  // Clusters on the right and bottom edges can be smaller
+    }
+
+    int neighbors[8];
+    for (int k = 0, count = map->GetNeighborIds(map->GetIndex(row, col), neighbors); k < count; ++k) {
+      int neighbor_row = map->GetRow(neighbors[k]);
+      int neighbor_col = map->GetCol(neighbors[k]);
+      if (neighbor_row >= graph.row && neighbor_row < row_end && neighbor_col >= graph.col && neighbor_col < col_end) {
+        graph.neighbors.push_back((neighbor_row - graph.row) * cluster_size + neighbor_col - graph.col);
+      }
+    }
+  }
+  graph.first.back() = static_cast<int>(graph.neighbors.size());
+}
+
+void HierarchicalMap::ClusterSearch(const ClusterGraph& graph, int source, std::vector<int>& distances, std::vector<int>* parents) const {
+  distances.assign(cluster_size * cluster_size, Map::UNREACHABLE);
+  if (parents) {
+    parents->assign(cluster_size * cluster_size, -1);
+  }
+
+  std::vector<int> frontier;
+  frontier.reserve(cluster_size * cluster_size);
+  frontier.push_back(GetLocalIndex(source));
+  distances[frontier[0]] = 0;
+  for (size_t head = 0; head < frontier.size(); ++head) {
+    int current = frontier[head];
+    int next_distance = distances[current] + 1;
+    for (int k = graph.first[current]; k < graph.first[current + 1]; ++k) {
+      int neighbor = graph.neighbors[k];
+      if (distances[neighbor] == Map::UNREACHABLE) {
+        distances[neighbor] = next_distance;
+        if (parents) {
+          (*parents)[neighbor] = current;
+        }
+        frontier.push_back(neighbor);
+      }
+    }
+  }
+}
+
+std::vector<int> HierarchicalMap::FindAbstractPath(int start, int goal) const {
+  if (!map->IsPassable(start) || !map->IsPassable(goal)) {
+    return {};
+  }
+
+  // Start and goal join the graph for this query only, linked to the entrances of their clusters
+  int node_count = static_cast<int>(node_cells.size());
+  int start_node = node_count;
+  int goal_node = node_count + 1;
+  auto cell_of = [&](int node) {
+    return node == start_node ? start : node == goal_node ? goal : node_cells[node];
+  };
+
+  ClusterGraph graph;
+  std::vector<int> distances;
+  std::vector<Edge> start_edges;
+  BuildClusterGraph(GetCluster(start), graph);
+  ClusterSearch(graph, start, distances);
+  for (int node : cluster_entrances[GetCluster(start)]) {
+    int distance = distances[GetLocalIndex(node_cells[node])];
+    if (distance != Map::UNREACHABLE) {
+      start_edges.push_back({node, distance});
+    }
+  }
+  if (GetCluster(goal) == GetCluster(start) && distances[GetLocalIndex(goal)] != Map::UNREACHABLE) {
+    start_edges.push_back({goal_node, distances[GetLocalIndex(goal)]});
+  }
+
+  std::unordered_map<int, int> goal_costs;  // Entrance node -> moves to the goal
+  if (GetCluster(goal) != GetCluster(start)) {
+    BuildClusterGraph(GetCluster(goal), graph);
+  }
+  ClusterSearch(graph, goal, distances);
+  for (int node : cluster_entrances[GetCluster(goal)]) {
+    int distance = distances[GetLocalIndex(node_cells[node])];
+    if (distance != Map::UNREACHABLE) {
+      goal_costs.emplace(node, distance);
+    }
+  }
+
+  // A* over the entrances; abstract costs are move counts, so the grid distance is consistent
+  std::vector<int> g_costs(node_count + 2, Map::UNREACHABLE);
+  std::vector<int> parents(node_count + 2, -1);
+  using Entry = std::pair<int, int>;  // f cost, node
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_set;
+  auto relax = [&](int from, int to, int cost) {
+    if (g_costs[from] + cost < g_costs[to]) {
+      g_costs[to] = g_costs[from] + cost;
+      parents[to] = from;
+      open_set.push({g_costs[to] + GridDistance(cell_of(to), goal), to});
+    }
+  };
+
+  g_costs[start_node] = 0;
+  open_set.push({GridDistance(start, goal), start_node});
+  while (!open_set.empty()) {
+    auto [f_cost, node] = open_set.top();
+    open_set.pop();
+    if (node == goal_node) {
+      break;
+    }
+    if (f_cost > g_costs[node] + GridDistance(cell_of(node), goal)) {
+      continue;  // Stale entry
+    }
+
+    for (const Edge& edge : node == start_node ? start_edges : edges[node]) {
+      relax(node, edge.to, edge.cost);
+    }
+    auto it = goal_costs.find(node);
+    if (node != start_node && it != goal_costs.end()) {
+      relax(node, goal_node, it->second);
+    }
+  }
+
+  if (g_costs[goal_node] == Map::UNREACHABLE) {
+    return {};
+  }
+  std::vector<int> path;
+  for (int node = goal_node; node != -1; node = parents[node]) {
+    path.push_back(cell_of(node));
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+std::vector<int> HierarchicalMap::RefineSegment(int from, int to) const {
+  if (from == to) {
+    return {};
+  }
+  if (GetCluster(from) != GetCluster(to)) {
+    return {to};  // One step across a cluster border
+  }
+
+  // Search from the end of the leg, so following parents walks from its start towards it
+  ClusterGraph graph;
+  std::vector<int> distances;
+  std::vector<int> parents;
+  BuildClusterGraph(GetCluster(to), graph);
+  ClusterSearch(graph, to, distances, &parents);
+  if (distances[GetLocalIndex(from)] == Map::UNREACHABLE) {
+    return {};
+  }
+
+  std::vector<int> cells;
+  for (int local = parents[GetLocalIndex(from)]; local != -1; local = parents[local]) {
+    cells.push_back(map->GetIndex(graph.row + local / cluster_size, graph.col + local % cluster_size));
+  }
+  return cells;
+}
+
+std::vector<int> HierarchicalMap::FindPath(int start, int goal) const {
+  std::vector<int> coarse = FindAbstractPath(start, goal);
+  if (coarse.empty()) {
+    return {};
+  }
+
+  std::vector<int> path = {start};
+  for (size_t i = 1; i < coarse.size(); ++i) {
+    std::vector<int> leg = RefineSegment(coarse[i - 1], coarse[i]);
+    if (leg.empty() && coarse[i - 1] != coarse[i]) {
+      return {};
+    }
+    path.insert(path.end(), leg.begin(), leg.end());
+  }
+  return path;
+}
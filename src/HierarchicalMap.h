@@ -0,0 +1,169 @@
+/**
+ * @file HierarchicalMap.h
+ * @brief Defines the HPA* abstraction of a map used for long-range paths.
+ *
+ * The grid is cut into square clusters. Where two clusters share a free
+ * border, one or two entrance cells on each side become nodes of an
+ * abstract graph, linked across the border and, inside each cluster, by
+ * their precomputed distances. A long path is then a short search over
+ * entrances, and only the legs that are actually needed are expanded into
+ * cells, by a search confined to one cluster.
+ */
+
+#ifndef HIERARCHICAL_MAP_H
+#define HIERARCHICAL_MAP_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "Map.h"
+
+/**
+ * @brief Clusters, entrances and intra-cluster distances of a map (HPA*).
+ *
+ * Paths only cross cluster borders at entrances, so they can be a few
+ * moves longer than the shortest path, and abstract distances overestimate
+ * true distances. The abstraction is read-only once built and can be
+ * shared between threads.
+ */
+class HierarchicalMap {
+public:
+    /// Default side length of a cluster in cells
+    static const int DEFAULT_CLUSTER_SIZE = 16;
+
+    /// Border segments at least this wide get an entrance at each end instead of one in the middle
+    static const int WIDE_ENTRANCE = 6;
+
+    /**
+     * @brief Builds the abstraction of a map.
+     *
+     * @param _map Shared pointer to the map
+     * @param _cluster_size Side length of a cluster in cells
+     */
+    HierarchicalMap(std::shared_ptr<const Map> _map, int _cluster_size = DEFAULT_CLUSTER_SIZE);
+
+    /**
+     * @brief Finds a coarse path over the entrances.
+     *
+     * @param start Flat index of the start cell
+     * @param goal Flat index of the goal cell
+     * @return Start, the entrances passed, and goal; empty if the abstract graph does not connect them
+     */
+    std::vector<int> FindAbstractPath(int start, int goal) const;
+
+    /**
+     * @brief Expands one leg of a coarse path into cells.
+     *
+     * Consecutive nodes either sit on both sides of a cluster border or in
+     * the same cluster, where the leg is a shortest path inside the cluster.
+     *
+     * @param from Flat index where the leg starts
+     * @param to Flat index where the leg ends
+     * @return Cells after `from` up to and including `to`; empty if not connected
+     */
+    std::vector<int> RefineSegment(int from, int to) const;
+
+    /**
+     * @brief Finds a coarse path and refines all of it.
+     *
+     * @param start Flat index of the start cell
+     * @param goal Flat index of the goal cell
+     * @return Cells from start to goal, empty if no path was found
+     */
+    std::vector<int> FindPath(int start, int goal) const;
+
+    /**
+     * @brief Gets the side length of a cluster.
+     */
+    int GetClusterSize() const { return cluster_size; }
+
+    /**
+     * @brief Gets the number of entrance nodes in the abstract graph.
+     */
+    int GetEntranceCount() const { return static_cast<int>(node_cells.size()); }
+
+private:
+    /**
+     * @brief Edge of the abstract graph.
+     */
+    struct Edge {
+        int to;    ///< Target node
+        int cost;  ///< Number of moves
+    };
+
+    /**
+     * @brief Moves that stay inside one cluster, over local cell indices.
+     *
+     * Built once per cluster search batch, so the searches themselves do not
+     * convert between flat and local indices.
+     */
+    struct ClusterGraph {
+        int row;                     ///< Row of the cluster's top-left cell
+        int col;                     ///< Column of the cluster's top-left cell
+        std::vector<int> first;      ///< Local cell -> offset of its neighbors in `neighbors` (one extra entry at the end)
+        std::vector<int> neighbors;  ///< Local indices of the passable neighbors inside the cluster
+    };
+
+    std::shared_ptr<const Map> map;          ///< Shared pointer to the map
+    int cluster_size;                        ///< Side length of a cluster in cells
+    int cluster_columns;                     ///< Clusters per row of clusters
+    std::vector<int> node_cells;             ///< Abstract node -> flat cell index
+    std::unordered_map<int, int> cell_nodes; ///< Flat cell index -> abstract node
+    std::vector<std::vector<Edge>> edges;    ///< Abstract node -> outgoing edges
+    std::vector<std::vector<int>> cluster_entrances;  ///< Cluster -> abstract nodes inside it
+
+    /**
+     * @brief Gets the cluster of a cell.
+     */
+    int GetCluster(int index) const;
+
+    /**
+     * @brief Gets the abstract node of an entrance cell, adding it if needed.
+     */
+    int AddEntrance(int index);
+
+    /**
+     * @brief Adds the entrances along the border between two adjacent clusters.
+     *
+     * @param first First cell of the border on the near side
+     * @param step Offset from one border cell to the next
+     * @param across Offset from a near-side cell to the cell across the border
+     * @param length Number of cells along the border
+     */
+    void AddBorderEntrances(int first, int step, int across, int length);
+
+    /**
+     * @brief Links every pair of entrances in a cluster by their distance inside it.
+     */
+    void ConnectCluster(int cluster);
+
+    /**
+     * @brief Gets the position of a cell within its cluster, below cluster size squared.
+     */
+    int GetLocalIndex(int index) const;
+
+    /**
+     * @brief Builds the moves inside a cluster.
+     *
+     * @param cluster Cluster index
+     * @param graph Output graph
+     */
+    void BuildClusterGraph(int cluster, ClusterGraph& graph) const;
+
+    /**
+     * @brief Breadth-first search from a cell that never leaves its cluster.
+     *
+     * @param graph Moves inside the cluster of the source
+     * @param source Flat index of the source cell
+     * @param distances Output: moves to each cell of the cluster by local index, Map::UNREACHABLE if not reached
+     * @param parents Output if not null: previous local index on a shortest path, -1 for the source
+     */
+    void ClusterSearch(const ClusterGraph& graph, int source, std::vector<int>& distances, std::vector<int>* parents = nullptr) const;
+
+    /**
+     * @brief Lower bound on the number of moves between two cells, ignoring obstacles.
+     */
+    int GridDistance(int from, int to) const;
+};
+
+#endif // HIERARCHICAL_MAP_H
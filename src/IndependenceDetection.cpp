@@ -0,0 +1,225 @@
+#include "IndependenceDetection.h"
+#include "CBS.h"
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <future>
+#include <thread>
+
+IndependenceDetection::IndependenceDetection(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents)
+  : Solver(_map, _agents), thread_count(std::max(1u, std::thread::hardware_concurrency())) {}
+
+void IndependenceDetection::SetThreadCount(int count) { thread_count = std::max(1, count); }
+
+void IndependenceDetection::SetGroupSetup(GroupSetup _group_setup) { group_setup = std::move(_group_setup); }
+
+bool IndependenceDetection::PathFind() {
+  BeginPathFind();
+
+  // Plan every agent alone
+  AStar astar(map);
+  astar.SetDeadline(deadline);
+  std::vector<std::vector<std::shared_ptr<Cell>>> solution(agents.size());
+  for (size_t i = 0; i < agents.size(); i++) {
+    const AgentData& data = agents[i]->GetAgentData();
+    solution[i] = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col, i, 0);
+    stats.AddSearch(astar.GetLastStats());
+    if (solution[i].empty()) {
+      if (DeadlinePassed()) {
+        if (verbose) {
+          std::cerr << "Independence detection reached its deadline while planning the root paths" << std::endl;
+        }
+        return false;
+      }
+      if (verbose) {
+        std::cerr << "No solution exists for at least one agent" << std::endl;
+      }
+      return false;
+    }
+  }
+
+  // Union-find over agents; every agent starts in its own group
+  std::vector<int> parent(agents.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](int agent) {
+    while (parent[agent] != agent) {
+      parent[agent] = parent[parent[agent]];
+      agent = parent[agent];
+    }
+    return agent;
+  };
+
+  int round_count = 0;
+  while (true) {
+    // Merge the groups of every conflicting pair
+    std::vector<int> merged_roots;
+    for (const auto& [a, b] : FindConflictingPairs(solution)) {
+      int root_a = find(a);
+      int root_b = find(b);
+      if (root_a != root_b) {
+        parent[root_b] = root_a;
+        merged_roots.push_back(root_a);
+      }
+    }
+    if (merged_roots.empty()) {
+      break;
+    }
+    round_count++;
+
+    // Replan each group that changed in this round
+    std::vector<int> changed_roots;
+    for (int root : merged_roots) {
+      changed_roots.push_back(find(root));
+    }
+    std::sort(changed_roots.begin(), changed_roots.end());
+    changed_roots.erase(std::unique(changed_roots.begin(), changed_roots.end()), changed_roots.end());
+
+    std::vector<std::vector<int>> groups(changed_roots.size());
+    for (size_t i = 0; i < agents.size(); i++) {
+      auto it = std::lower_bound(changed_roots.begin(), changed_roots.end(), find(i));
+      if (it != changed_roots.end() && *it == find(i)) {
+        groups[it - changed_roots.begin()].push_back(i);
+      }
+    }
+
+    if (!SolveGroups(groups, solution)) {
+      return false;
+    }
+  }
+
+  // Report the final decomposition
+  std::vector<int> group_sizes(agents.size(), 0);
+  for (size_t i = 0; i < agents.size(); i++) {
+    group_sizes[find(i)]++;
+  }
+  int group_count = std::count_if(group_sizes.begin(), group_sizes.end(), [](int size) { return size > 0; });
+  int largest_group = agents.empty() ? 0 : *std::max_element(group_sizes.begin(), group_sizes.end());
+
+  // Publish the final solution to the map and the agents
+  ApplySolution(solution);
+
+  if (verbose) {
+    std::cout << "Independence detection: " << group_count << " groups after " << round_count
+              << " merge rounds, largest has " << largest_group << " agents" << std::endl;
+    std::cout << "Solution found with cost: " << CalculateSolutionCost(solution) << std::endl;
+  }
+  return true;
+}
+
+std::vector<std::pair<int, int>> IndependenceDetection::FindConflictingPairs(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  MAPF_STATS_TIMER(conflict_timer, stats.conflict_detection_ms);
+  std::vector<std::pair<int, int>> pairs;
+  size_t makespan = 0;
+  for (const auto& path : solution) {
+    makespan = std::max(makespan, path.size());
+  }
+
+  // Agents stay at their goal once their path ends
+  auto position = [&](size_t agent_id, size_t t) {
+    const auto& path = solution[agent_id];
+    const auto& cell = path[std::min(t, path.size() - 1)];
+    return map->GetIndex(cell->row, cell->col);
+  };
+
+  std::vector<int> previous(map->GetCellCount(), -1);  // Cell -> agent at t - 1
+  std::vector<int> occupant(map->GetCellCount(), -1);  // Cell -> agent at t
+
+  for (size_t t = 0; t < makespan; t++) {
+    for (size_t i = 0; i < solution.size(); i++) {
+      int cell = position(i, t);
+
+      // Vertex conflict: the cell is already taken at t
+      if (occupant[cell] != -1) {
+        pairs.emplace_back(occupant[cell], i);
+      } else {
+        occupant[cell] = i;
+      }
+
+      // Edge conflict: the agent that was at our target moves into our previous cell
+      if (t > 0) {
+        int from = position(i, t - 1);
+        int other = previous[cell];
+        if (from != cell && other != -1 && other != static_cast<int>(i) && position(other, t) == from) {
+          pairs.emplace_back(other, i);
+        }
+      }
+    }
+
+    // Move the occupancy of t into previous, resetting only touched cells
+    for (size_t i = 0; i < solution.size(); i++) {
+      if (t > 0) previous[position(i, t - 1)] = -1;
+    }
+    for (size_t i = 0; i < solution.size(); i++) {
+      int cell = position(i, t);
+      previous[cell] = occupant[cell];
+    }
+    for (size_t i = 0; i < solution.size(); i++) {
+      occupant[position(i, t)] = -1;
+    }
+  }
+
+  return pairs;
+}
+
+bool IndependenceDetection::SolveGroups(const std::vector<std::vector<int>>& groups,
+                                        std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  std::atomic<size_t> next_group(0);
+  std::atomic<bool> failed(false);
+  std::vector<SolverStats> group_stats(groups.size());  // One slot per group, so workers never share one
+
+  // Each worker takes the next unsolved group; groups are disjoint, so their paths never overlap
+  auto worker = [&]() {
+    for (size_t g = next_group++; g < groups.size() && !failed; g = next_group++) {
+      std::vector<std::shared_ptr<Agent>> group_agents;
+      for (int agent_id : groups[g]) {
+        group_agents.push_back(agents[agent_id]);
+      }
+
+      CBS cbs(map, group_agents);
+      if (group_setup) {
+        group_setup(cbs);
+      }
+      cbs.SetPublishSolution(false);
+      cbs.SetVerbose(verbose);
+      cbs.SetDeadline(deadline);
+      bool solved = cbs.PathFind();
+      group_stats[g] = cbs.GetStats();
+      if (!solved) {
+        failed = true;
+        return;
+      }
+
+      const auto& group_solution = cbs.GetSolution();
+      for (size_t k = 0; k < groups[g].size(); k++) {
+        solution[groups[g][k]] = group_solution[k];
+      }
+    }
+  };
+
+  int workers = std::min<int>(thread_count, groups.size());
+  std::vector<std::future<void>> futures;
+  for (int w = 1; w < workers; w++) {
+    futures.push_back(std::async(std::launch::async, worker));
+  }
+  worker();
+  for (auto& future : futures) {
+    future.get();
+  }
+  for (const SolverStats& group : group_stats) {
+    stats.Merge(group);
+  }
+
+  if (failed) {
+    if (DeadlinePassed()) {
+      if (verbose) {
+        std::cerr << "Independence detection reached its deadline" << std::endl;
+      }
+      return false;
+    }
+    if (verbose) {
+      std::cerr << "CBS failed to solve a merged group" << std::endl;
+    }
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file IndependenceDetection.h
+ * @brief Defines the Independence Detection (ID) front end for CBS.
+ *
+ * Independence Detection starts with every agent in its own group and plans
+ * each agent alone. Groups whose paths conflict are merged and replanned
+ * together with CBS, until no two groups conflict. Agents that never
+ * interact are never coupled, so CBS only sees the groups that need it.
+ */
+
+#ifndef INDEPENDENCE_DETECTION_H
+#define INDEPENDENCE_DETECTION_H
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+#include "Map.h"
+#include "Agent.h"
+#include "AStar.h"
+#include "Solver.h"
+
+class CBS;
+
+/**
+ * @brief Decomposes an instance into independent groups solved by CBS.
+ *
+ * Groups merged in the same round are disjoint, so their CBS searches run
+ * in parallel on worker threads.
+ */
+class IndependenceDetection : public Solver {
+public:
+    /**
+     * @brief Applies engine settings to the CBS search of a merged group.
+     *
+     * Called from the worker threads, so it must only read shared state.
+     */
+    using GroupSetup = std::function<void(CBS& cbs)>;
+
+    /**
+     * @brief Constructs a new Independence Detection solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    IndependenceDetection(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Sets the number of threads that solve groups in parallel.
+     *
+     * @param count Thread count, at least 1 (default: hardware concurrency)
+     */
+    void SetThreadCount(int count);
+
+    /**
+     * @brief Sets how the CBS search of each merged group is configured.
+     *
+     * @param _group_setup Applies the settings, e.g. the iteration limit; groups use the CBS defaults without one
+     */
+    void SetGroupSetup(GroupSetup _group_setup);
+
+    /**
+     * @brief Plans all agents, merging groups until none conflict.
+     *
+     * @return true if every group was solved
+     */
+    bool PathFind() override;
+
+private:
+    int thread_count;  ///< Worker threads for group searches
+    GroupSetup group_setup;  ///< Configures the CBS search of each group
+
+    /**
+     * @brief Finds all pairs of agents whose paths conflict.
+     *
+     * Sweeps time once over a flat cell-to-agent array instead of testing
+     * every pair of paths.
+     *
+     * @param solution Paths for all agents
+     * @return Conflicting agent pairs (a pair may appear more than once)
+     */
+    std::vector<std::pair<int, int>> FindConflictingPairs(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+
+    /**
+     * @brief Solves several groups with CBS on worker threads.
+     *
+     * @param groups Agent indices of each group
+     * @param solution Paths for all agents; the paths of every group are replaced
+     * @return false if CBS failed for some group
+     */
+    bool SolveGroups(const std::vector<std::vector<int>>& groups,
+                     std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+};
+
+#endif // INDEPENDENCE_DETECTION_H
@@ -0,0 +1,199 @@
+#include "InstanceGenerator.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+InstanceGenerator::InstanceGenerator(int _width, int _height, uint64_t seed)
+  : width(_width), height(_height), terrain(static_cast<size_t>(_width) * _height, '.'), rng(seed) {}
+
+MapKind InstanceGenerator::ParseMapKind(const std::string& name) {
+  if (name == "random") return MapKind::RANDOM;
+  if (name == "warehouse") return MapKind::WAREHOUSE;
+  if (name == "rooms") return MapKind::ROOMS;
+  if (name == "maze") return MapKind::MAZE;
+  throw std::invalid_argument("Unknown map kind: " + name);
+}
+
+int InstanceGenerator::RandomInt(int low, int high) {
+  return std::uniform_int_distribution<int>(low, high)(rng);
+}
+
+void InstanceGenerator::Fill(int row, int col, int rows, int cols, char icon) {
+  for (int r = std::max(0, row); r < std::min(height, row + rows); r++) {
+    for (int c = std::max(0, col); c < std::min(width, col + cols); c++) {
+      terrain[r * width + c] = icon;
+    }
+  }
+}
+
+int InstanceGenerator::CountFreeCells() const {
+  return static_cast<int>(std::count(terrain.begin(), terrain.end(), '.'));
+}
+
+void InstanceGenerator::GenerateRandom(double density) {
+  std::bernoulli_distribution obstacle(density);
+  for (char& icon : terrain) {
+    icon = obstacle(rng) ? '@' : '.';
+  }
+}
+
+void InstanceGenerator::GenerateWarehouse(int shelf_length, int aisle_width) {
+  std::fill(terrain.begin(), terrain.end(), '.');
+
+  // As many shelves as fit inside the border, centered
+  int border = 2 * aisle_width;
+  int shelf_rows = std::max(0, (height - 2 * border + aisle_width) / (SHELF_DEPTH + aisle_width));
+  int shelf_cols = std::max(0, (width - 2 * border + aisle_width) / (shelf_length + aisle_width));
+  int first_row = (height - shelf_rows * (SHELF_DEPTH + aisle_width) + aisle_width) / 2;
+  int first_col = (width - shelf_cols * (shelf_length + aisle_width) + aisle_width) / 2;
+  for (int i = 0; i < shelf_rows; i++) {
+    for (int j = 0; j < shelf_cols; j++) {
+      Fill(first_row + i * (SHELF_DEPTH + aisle_width), first_col + j * (shelf_length + aisle_width),
+           SHELF_DEPTH, shelf_length, '@');
+    }
+  }
+}
+
+void InstanceGenerator::GenerateRooms(int room_size) {
+  int pitch = room_size + 1;
+  for (int row = 0; row < height; row++) {
+    for (int col = 0; col < width; col++) {
+      terrain[row * width + col] = row % pitch == room_size || col % pitch == room_size ? '@' : '.';
+    }
+  }
+
+  // One door per wall segment between two rooms keeps all rooms connected
+  for (int wall = room_size; wall + 1 < height; wall += pitch) {
+    for (int col = 0; col < width; col += pitch) {
+      terrain[wall * width + RandomInt(col, std::min(col + room_size, width) - 1)] = '.';
+    }
+  }
+  for (int wall = room_size; wall + 1 < width; wall += pitch) {
+    for (int row = 0; row < height; row += pitch) {
+      terrain[RandomInt(row, std::min(row + room_size, height) - 1) * width + wall] = '.';
+    }
+  }
+}
+
+void InstanceGenerator::GenerateMaze(int corridor_width) {
+  std::fill(terrain.begin(), terrain.end(), '@');
+  if (corridor_width > width || corridor_width > height) {
+    return;
+  }
+
+  // Maze cells are corridor_width squares, one wall cell apart
+  int pitch = corridor_width + 1;
+  int rows = (height - corridor_width) / pitch + 1;
+  int cols = (width - corridor_width) / pitch + 1;
+  const int steps[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+
+  // Iterative depth-first search, so large mazes do not overflow the call stack
+  std::vector<uint8_t> visited(rows * cols, 0);
+  std::vector<int> stack = {0};
+  visited[0] = 1;
+  Fill(0, 0, corridor_width, corridor_width, '.');
+  while (!stack.empty()) {
+    int row = stack.back() / cols;
+    int col = stack.back() % cols;
+    int options[4];
+    int count = 0;
+    for (int k = 0; k < 4; k++) {
+      int next_row = row + steps[k][0];
+      int next_col = col + steps[k][1];
+      if (next_row >= 0 && next_row < rows && next_col >= 0 && next_col < cols && !visited[next_row * cols + next_col]) {
+        options[count++] = k;
+      }
+    }
+    if (count == 0) {
+      stack.pop_back();
+      continue;
+    }
+
+    // Carve the wall and the next cell in one rectangle
+    int k = options[RandomInt(0, count - 1)];
+    int next_row = row + steps[k][0];
+    int next_col = col + steps[k][1];
+    Fill(std::min(row, next_row) * pitch, std::min(col, next_col) * pitch,
+         corridor_width + (steps[k][0] != 0 ? pitch : 0), corridor_width + (steps[k][1] != 0 ? pitch : 0), '.');
+    visited[next_row * cols + next_col] = 1;
+    stack.push_back(next_row * cols + next_col);
+  }
+}
+
+bool InstanceGenerator::WriteMap(const std::string& path, MovementType movement) const {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Error: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  file << "type " << (movement == MovementType::OCTILE ? "octile" : "manhattan") << "\n"
+       << "height " << height << "\n"
+       << "width " << width << "\n"
+       << "map\n";
+  for (int row = 0; row < height; row++) {
+    file.write(terrain.data() + static_cast<size_t>(row) * width, width);
+    file << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+std::vector<AgentData> InstanceGenerator::GenerateAgents(const Map& map, int count) {
+  std::vector<int> free_cells;
+  for (int index = 0; index < map.GetCellCount(); index++) {
+    if (map.IsPassable(index)) {
+      free_cells.push_back(index);
+    }
+  }
+
+  // Goals in shuffled order are distinct; starts are drawn among the cells that reach the goal
+  std::shuffle(free_cells.begin(), free_cells.end(), rng);
+  std::vector<uint8_t> used_start(map.GetCellCount(), 0);
+  std::vector<int> distances(map.GetCellCount());
+  std::vector<AgentData> agents;
+  for (size_t g = 0; g < free_cells.size() && static_cast<int>(agents.size()) < count; g++) {
+    int goal = free_cells[g];
+    map.ComputeDistances(goal, distances.data());
+
+    int start = -1;
+    for (int attempt = 0; attempt < START_ATTEMPTS && start < 0; attempt++) {
+      int candidate = free_cells[RandomInt(0, static_cast<int>(free_cells.size()) - 1)];
+      if (candidate != goal && !used_start[candidate] && distances[candidate] != Map::UNREACHABLE) {
+        start = candidate;
+      }
+    }
+    if (start < 0) {
+      continue;  // The goal lies in a small pocket of the map
+    }
+
+    used_start[start] = 1;
+    agents.push_back({static_cast<int>(agents.size()), map.GetRow(start), map.GetCol(start),
+                      map.GetRow(goal), map.GetCol(goal), static_cast<double>(distances[start])});
+  }
+
+  if (static_cast<int>(agents.size()) < count) {
+    throw std::runtime_error("Only " + std::to_string(agents.size()) + " of " + std::to_string(count) +
+                             " agents fit on map " + map.GetName());
+  }
+  return agents;
+}
+
+bool InstanceGenerator::WriteScenario(const std::string& path, const std::string& map_file, const Map& map,
+                                      const std::vector<AgentData>& agents) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Error: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  file << "version 1\n" << std::fixed << std::setprecision(8);
+  for (const AgentData& agent : agents) {
+    file << static_cast<int>(agent.optimal_distance) / 4 << '\t' << map_file << '\t'
+         << map.GetHeight() << '\t' << map.GetWidth() << '\t'
+         << agent.start_row << '\t' << agent.start_col << '\t'
+         << agent.dest_row << '\t' << agent.dest_col << '\t' << agent.optimal_distance << '\n';
+  }
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file InstanceGenerator.h
+ * @brief Defines the generator of synthetic maps and scenarios.
+ *
+ * The shipped instances are a single small maze. The generator produces
+ * maps of any size in the MovingAI format, in the layouts used by the
+ * standard benchmark sets, and scenarios with any number of agents for
+ * them, so the engines can be tested at scale.
+ */
+
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include "Map.h"
+#include "Agent.h"
+
+/**
+ * @brief Layout of a generated map.
+ */
+enum class MapKind {
+    RANDOM,     ///< Obstacles placed independently at a given density
+    WAREHOUSE,  ///< Rows of shelves separated by aisles, with a free border
+    ROOMS,      ///< Square rooms joined by one door per shared wall
+    MAZE        ///< Perfect maze of corridors of a given width
+};
+
+/**
+ * @brief Generates MovingAI maps and scenarios from a seed.
+ *
+ * The same seed and parameters always give the same files. A map is built
+ * in memory by one of the Generate methods and written with WriteMap();
+ * scenarios are drawn on the map as loaded back by Map, so their distances
+ * follow the same movement rules as the engines.
+ */
+class InstanceGenerator {
+public:
+    /// Depth of a warehouse shelf in cells
+    static const int SHELF_DEPTH = 2;
+
+    /// Random start cells tried for a goal before the goal is given up
+    static const int START_ATTEMPTS = 100;
+
+    /**
+     * @brief Constructs a generator with an empty map.
+     *
+     * @param _width Map width in cells
+     * @param _height Map height in cells
+     * @param seed Seed of the random number generator
+     */
+    InstanceGenerator(int _width, int _height, uint64_t seed);
+
+    /**
+     * @brief Converts a layout name to a map kind.
+     *
+     * @param name One of "random", "warehouse", "rooms" or "maze"
+     * @return The map kind
+     * @throw std::invalid_argument if the name is unknown
+     */
+    static MapKind ParseMapKind(const std::string& name);
+
+    /**
+     * @brief Places obstacles independently in each cell.
+     *
+     * Parts of the map can be cut off; scenarios only pair connected cells.
+     *
+     * @param density Probability of a cell being an obstacle
+     */
+    void GenerateRandom(double density);
+
+    /**
+     * @brief Builds rows of shelves two cells deep.
+     *
+     * Shelves are separated by aisles and surrounded by a free border twice
+     * the aisle width, where agents can pass around the shelf blocks.
+     *
+     * @param shelf_length Length of a shelf in cells
+     * @param aisle_width Width of the aisles between shelves
+     */
+    void GenerateWarehouse(int shelf_length, int aisle_width);
+
+    /**
+     * @brief Builds a grid of rooms with a door in every wall between two rooms.
+     *
+     * @param room_size Side length of a room in cells, without walls
+     */
+    void GenerateRooms(int room_size);
+
+    /**
+     * @brief Builds a perfect maze with a randomized depth-first search.
+     *
+     * Every corridor cell is reachable from every other one by exactly one
+     * route; walls between corridors are one cell thick.
+     *
+     * @param corridor_width Width of the corridors in cells
+     */
+    void GenerateMaze(int corridor_width);
+
+    /**
+     * @brief Writes the map in the MovingAI format.
+     *
+     * @param path Output file
+     * @param movement Movement type written to the header
+     * @return false (after printing an error) if the file cannot be written
+     */
+    bool WriteMap(const std::string& path, MovementType movement) const;
+
+    /**
+     * @brief Draws start and goal cells for a number of agents.
+     *
+     * All starts are different, all goals are different, and every start
+     * can reach its own goal. The optimal distance of an agent is its
+     * number of moves, found by breadth-first search from its goal.
+     *
+     * @param map Generated map, loaded back from its file
+     * @param count Number of agents
+     * @return One entry per agent
+     * @throw std::runtime_error if the map has too few connected free cells
+     */
+    std::vector<AgentData> GenerateAgents(const Map& map, int count);
+
+    /**
+     * @brief Writes a scenario in the MovingAI format.
+     *
+     * Fields are written in the order Manager::ReadScenario() reads them,
+     * with the bucket set to a quarter of the optimal distance.
+     *
+     * @param path Output file
+     * @param map_file Map file name recorded on every line
+     * @param map Map of the scenario
+     * @param agents Agents to write
+     * @return false (after printing an error) if the file cannot be written
+     */
+    static bool WriteScenario(const std::string& path, const std::string& map_file, const Map& map,
+                              const std::vector<AgentData>& agents);
+
+    /**
+     * @brief Gets the number of free cells of the generated map.
+     */
+    int CountFreeCells() const;
+
+private:
+    int width;                ///< Map width in cells
+    int height;               ///< Map height in cells
+    std::vector<char> terrain;  ///< Row-major terrain, '.' free and '@' obstacle
+    std::mt19937_64 rng;      ///< Source of all random choices
+
+    /**
+     * @brief Sets the terrain of a rectangle, clipped to the map.
+     *
+     * @param row First row
+     * @param col First column
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param icon Terrain character to set
+     */
+    void Fill(int row, int col, int rows, int cols, char icon);
+
+    /**
+     * @brief Draws a uniformly distributed integer.
+     *
+     * @param low Smallest value
+     * @param high Largest value
+     * @return Value in [low, high]
+     */
+    int RandomInt(int low, int high);
+};
+
+#endif // INSTANCE_GENERATOR_H
@@ -0,0 +1,287 @@
+#include "LNS.h"
+#include <numeric>
+#include <unordered_set>
+#include <unordered_map>
+
+LNS::LNS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents)
+  : Solver(_map, _agents), time_limit(1.0), neighborhood_size(8),
+    neighborhood_type(NeighborhoodType::ADAPTIVE), rng(0), strategy_weights(3, 1.0) {}
+
+void LNS::SetTimeLimit(double seconds) { time_limit = seconds; }
+void LNS::SetNeighborhoodSize(int size) { neighborhood_size = std::max(1, size); }
+void LNS::SetNeighborhoodType(NeighborhoodType type) { neighborhood_type = type; }
+void LNS::SetSeed(unsigned int seed) { rng.seed(seed); }
+
+const std::vector<std::pair<double, int>>& LNS::GetCostTrajectory() const { return cost_trajectory; }
+
+double LNS::Elapsed() const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+bool LNS::PathFind() {
+  start_time = std::chrono::steady_clock::now();
+  cost_trajectory.clear();
+  BeginPathFind();
+
+  AStar astar(map);
+  astar.SetDeadline(deadline);
+  std::vector<std::vector<std::shared_ptr<Cell>>> solution(agents.size());
+
+  // Individually shortest paths, used to measure delays
+  shortest_paths.assign(agents.size(), {});
+  for (size_t i = 0; i < agents.size(); i++) {
+    const AgentData& data = agents[i]->GetAgentData();
+    auto path = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col, i, 0);
+    stats.AddSearch(astar.GetLastStats());
+    if (path.empty()) {
+      if (verbose) {
+        std::cerr << "No solution exists for at least one agent" << std::endl;
+      }
+      return false;
+    }
+    shortest_paths[i] = path;
+  }
+
+  if (!FindInitialSolution(solution, astar)) {
+    if (verbose) {
+      std::cerr << "LNS found no initial solution within " << time_limit << " seconds" << std::endl;
+    }
+    return false;
+  }
+
+  int cost = CalculateSolutionCost(solution);
+  cost_trajectory.emplace_back(Elapsed(), cost);
+
+  // Improve the solution until the deadline
+  int iteration_count = 0;
+  while (Elapsed() < time_limit && agents.size() > 1 && !DeadlinePassed()) {
+    // Choose the strategy for this iteration
+    int strategy = static_cast<int>(neighborhood_type);
+    if (neighborhood_type == NeighborhoodType::ADAPTIVE) {
+      std::discrete_distribution<int> pick(strategy_weights.begin(), strategy_weights.end());
+      strategy = pick(rng);
+    }
+
+    std::vector<int> neighborhood;
+    switch (static_cast<NeighborhoodType>(strategy)) {
+      case NeighborhoodType::AGENT_BASED:
+        neighborhood = AgentBasedNeighborhood(solution);
+        break;
+      case NeighborhoodType::INTERSECTION:
+        neighborhood = IntersectionNeighborhood(solution);
+        break;
+      case NeighborhoodType::RANDOM:
+      default:
+        neighborhood = RandomNeighborhood(solution);
+        break;
+    }
+    iteration_count++;
+    if (neighborhood.empty()) {
+      continue;
+    }
+
+    // Reserve the paths of every agent outside the neighborhood
+    std::unordered_set<int> freed(neighborhood.begin(), neighborhood.end());
+    ReservationTable reservations;
+    for (size_t i = 0; i < solution.size(); i++) {
+      if (freed.count(i) == 0) {
+        reservations.ReservePath(solution[i], i);
+      }
+    }
+
+    // Remember the current paths in case the replanned ones are worse
+    std::vector<std::vector<std::shared_ptr<Cell>>> old_paths;
+    int old_neighborhood_cost = 0;
+    for (int a : neighborhood) {
+      old_paths.push_back(solution[a]);
+      old_neighborhood_cost += solution[a].size();
+    }
+
+    // Replan the neighborhood in a random order
+    std::vector<int> order = neighborhood;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    bool replanned = PlanInOrder(order, reservations, solution, astar);
+    int new_neighborhood_cost = 0;
+    for (int a : neighborhood) {
+      new_neighborhood_cost += solution[a].size();
+    }
+
+    double improvement = 0.0;
+    if (replanned && new_neighborhood_cost < old_neighborhood_cost) {
+      // Keep the cheaper paths
+      improvement = old_neighborhood_cost - new_neighborhood_cost;
+      cost -= old_neighborhood_cost - new_neighborhood_cost;
+      cost_trajectory.emplace_back(Elapsed(), cost);
+    } else {
+      // Restore the previous paths
+      for (size_t k = 0; k < neighborhood.size(); k++) {
+        solution[neighborhood[k]] = old_paths[k];
+      }
+    }
+
+    if (neighborhood_type == NeighborhoodType::ADAPTIVE) {
+      const double reaction = 0.1;
+      strategy_weights[strategy] = (1.0 - reaction) * strategy_weights[strategy] + reaction * improvement;
+      strategy_weights[strategy] = std::max(strategy_weights[strategy], 1e-3);
+    }
+  }
+
+  // Publish the final solution to the map and the agents
+  ApplySolution(solution);
+
+  if (verbose) {
+    std::cout << "LNS cost trajectory (" << iteration_count << " iterations):" << std::endl;
+    for (const auto& [seconds, trajectory_cost] : cost_trajectory) {
+      std::cout << "  " << seconds << "s: " << trajectory_cost << std::endl;
+    }
+    std::cout << "Solution found with cost: " << cost << std::endl;
+  }
+  return true;
+}
+
+bool LNS::PlanInOrder(const std::vector<int>& order, ReservationTable& reservations,
+                      std::vector<std::vector<std::shared_ptr<Cell>>>& solution, AStar& astar) {
+  for (int agent_id : order) {
+    const AgentData& data = agents[agent_id]->GetAgentData();
+    auto path = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col,
+                               agent_id, 0, reservations);
+    stats.AddSearch(astar.GetLastStats());
+    if (path.empty()) {
+      return false;
+    }
+
+    reservations.ReservePath(path, agent_id);
+    solution[agent_id] = path;
+  }
+  return true;
+}
+
+bool LNS::FindInitialSolution(std::vector<std::vector<std::shared_ptr<Cell>>>& solution, AStar& astar) {
+  // Reuse the agents' current paths if they form a feasible solution
+  bool has_paths = true;
+  for (size_t i = 0; i < agents.size(); i++) {
+    auto path = agents[i]->GetPath();
+    const AgentData& data = agents[i]->GetAgentData();
+    if (path.empty() || path.front()->row != data.start_row || path.front()->col != data.start_col ||
+        path.back()->row != data.dest_row || path.back()->col != data.dest_col) {
+      has_paths = false;
+      break;
+    }
+    solution[i] = path;
+  }
+  if (has_paths && !FindConflict(solution)) {
+    return true;
+  }
+
+  // Otherwise restart prioritized planning with random orders
+  std::vector<int> order(agents.size());
+  std::iota(order.begin(), order.end(), 0);
+  do {
+    ReservationTable reservations;
+    if (PlanInOrder(order, reservations, solution, astar)) {
+      return true;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+  } while (Elapsed() < time_limit && !DeadlinePassed());
+
+  return false;
+}
+
+std::vector<int> LNS::RandomNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  std::vector<int> all(solution.size());
+  std::iota(all.begin(), all.end(), 0);
+  std::shuffle(all.begin(), all.end(), rng);
+  all.resize(std::min<size_t>(neighborhood_size, all.size()));
+  return all;
+}
+
+std::vector<int> LNS::AgentBasedNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  // Pick a delayed agent, with probability proportional to its delay
+  std::vector<double> delays(solution.size());
+  bool any_delay = false;
+  for (size_t i = 0; i < solution.size(); i++) {
+    delays[i] = static_cast<double>(solution[i].size()) - shortest_paths[i].size();
+    any_delay = any_delay || delays[i] > 0;
+  }
+  if (!any_delay) {
+    return RandomNeighborhood(solution);
+  }
+  int seed_agent = std::discrete_distribution<int>(delays.begin(), delays.end())(rng);
+
+  // Index which agents visit each cell
+  std::unordered_map<long long, std::vector<int>> visitors;
+  for (size_t i = 0; i < solution.size(); i++) {
+    for (const auto& cell : solution[i]) {
+      auto& list = visitors[static_cast<long long>(cell->row) * map->GetWidth() + cell->col];
+      if (list.empty() || list.back() != static_cast<int>(i)) {
+        list.push_back(i);
+      }
+    }
+  }
+
+  // Add agents that occupy cells on the seed agent's unconstrained shortest path
+  std::vector<int> neighborhood = {seed_agent};
+  std::unordered_set<int> chosen = {seed_agent};
+  for (const auto& cell : shortest_paths[seed_agent]) {
+    for (int other : visitors[static_cast<long long>(cell->row) * map->GetWidth() + cell->col]) {
+      if (static_cast<int>(neighborhood.size()) >= neighborhood_size) {
+        return neighborhood;
+      }
+      if (chosen.insert(other).second) {
+        neighborhood.push_back(other);
+      }
+    }
+  }
+  return neighborhood;
+}
+
+std::vector<int> LNS::IntersectionNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  // Index which agents visit each cell
+  std::unordered_map<long long, std::vector<int>> visitors;
+  std::vector<std::pair<int, int>> intersections;
+  for (size_t i = 0; i < solution.size(); i++) {
+    for (const auto& cell : solution[i]) {
+      long long key = static_cast<long long>(cell->row) * map->GetWidth() + cell->col;
+      auto& list = visitors[key];
+      if (list.empty() && map->GetNeighbors(cell->row, cell->col).size() > 2) {
+        intersections.emplace_back(cell->row, cell->col);
+      }
+      if (list.empty() || list.back() != static_cast<int>(i)) {
+        list.push_back(i);
+      }
+    }
+  }
+  if (intersections.empty()) {
+    return RandomNeighborhood(solution);
+  }
+
+  // Breadth-first search around a random visited intersection
+  auto start = intersections[std::uniform_int_distribution<size_t>(0, intersections.size() - 1)(rng)];
+  std::vector<int> neighborhood;
+  std::unordered_set<int> chosen;
+  std::unordered_set<long long> seen = {static_cast<long long>(start.first) * map->GetWidth() + start.second};
+  std::queue<std::pair<int, int>> frontier;
+  frontier.push(start);
+
+  while (!frontier.empty() && static_cast<int>(neighborhood.size()) < neighborhood_size) {
+    auto [row, col] = frontier.front();
+    frontier.pop();
+
+    auto it = visitors.find(static_cast<long long>(row) * map->GetWidth() + col);
+    if (it != visitors.end()) {
+      for (int other : it->second) {
+        if (static_cast<int>(neighborhood.size()) < neighborhood_size && chosen.insert(other).second) {
+          neighborhood.push_back(other);
+        }
+      }
+    }
+
+    for (const auto& [nrow, ncol] : map->GetNeighbors(row, col)) {
+      if (seen.insert(static_cast<long long>(nrow) * map->GetWidth() + ncol).second) {
+        frontier.push({nrow, ncol});
+      }
+    }
+  }
+  return neighborhood;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file LNS.h
+ * @brief Defines the Large Neighborhood Search (MAPF-LNS) engine.
+ *
+ * LNS starts from any feasible solution and keeps improving it until a
+ * deadline. Each iteration frees a small group of agents, replans them with
+ * all other paths fixed, and keeps the new paths if the sum of costs drops.
+ */
+
+#ifndef LNS_H
+#define LNS_H
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <utility>
+#include <chrono>
+#include "Map.h"
+#include "Agent.h"
+#include "AStar.h"
+#include "Solver.h"
+#include "ReservationTable.h"
+
+/**
+ * @brief Strategies for choosing the agents replanned in one iteration.
+ */
+enum class NeighborhoodType {
+    RANDOM,        ///< Uniformly random agents
+    AGENT_BASED,   ///< The most delayed agent plus the agents blocking it
+    INTERSECTION,  ///< Agents passing through nearby intersection cells
+    ADAPTIVE       ///< Pick one of the above, weighted by past improvements
+};
+
+/**
+ * @brief Implements anytime improvement with Large Neighborhood Search.
+ */
+class LNS : public Solver {
+public:
+    /**
+     * @brief Constructs a new LNS solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    LNS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Sets how long the improvement phase may run.
+     *
+     * @param seconds Wall-clock budget, including finding the initial solution
+     */
+    void SetTimeLimit(double seconds);
+
+    /**
+     * @brief Sets the number of agents replanned per iteration.
+     *
+     * @param size Neighborhood size
+     */
+    void SetNeighborhoodSize(int size);
+
+    /**
+     * @brief Sets the neighborhood selection strategy.
+     *
+     * @param type Strategy to use
+     */
+    void SetNeighborhoodType(NeighborhoodType type);
+
+    /**
+     * @brief Seeds the random number generator.
+     *
+     * @param seed Seed value
+     */
+    void SetSeed(unsigned int seed);
+
+    /**
+     * @brief Finds a feasible solution and improves it until the deadline.
+     *
+     * If every agent already carries a path (e.g. from a previous engine),
+     * those paths are used as the initial solution.
+     *
+     * @return true if a feasible solution was found
+     */
+    bool PathFind() override;
+
+    /**
+     * @brief Gets the cost of every accepted solution over time.
+     *
+     * @return Pairs of (seconds since start, sum of costs)
+     */
+    const std::vector<std::pair<double, int>>& GetCostTrajectory() const;
+
+private:
+    double time_limit;                  ///< Wall-clock budget in seconds
+    int neighborhood_size;              ///< Agents replanned per iteration
+    NeighborhoodType neighborhood_type; ///< Neighborhood selection strategy
+    std::mt19937 rng;                   ///< Random number generator
+    std::vector<std::vector<std::shared_ptr<Cell>>> shortest_paths;  ///< Path of each agent without other agents
+    std::vector<double> strategy_weights;  ///< Adaptive weights for the three strategies
+    std::vector<std::pair<double, int>> cost_trajectory;  ///< (time, cost) of accepted solutions
+    std::chrono::steady_clock::time_point start_time;     ///< When PathFind started
+
+    /**
+     * @brief Plans agents one by one around the reserved paths.
+     *
+     * @param order Agents to plan, highest priority first
+     * @param reservations Reservations of the fixed agents, extended in place
+     * @param solution Solution to write the new paths into
+     * @param astar Low-level planner
+     * @return false if some agent has no path
+     */
+    bool PlanInOrder(const std::vector<int>& order, ReservationTable& reservations,
+                     std::vector<std::vector<std::shared_ptr<Cell>>>& solution, AStar& astar);
+
+    /**
+     * @brief Builds an initial solution with randomly restarted prioritized planning.
+     *
+     * @param solution Output solution
+     * @param astar Low-level planner
+     * @return true if a feasible solution was found before the deadline
+     */
+    bool FindInitialSolution(std::vector<std::vector<std::shared_ptr<Cell>>>& solution, AStar& astar);
+
+    /**
+     * @brief Gets the seconds elapsed since PathFind started.
+     */
+    double Elapsed() const;
+
+    /**
+     * @brief Neighborhood selection strategies.
+     *
+     * @param solution Current solution
+     * @return Agents to replan
+     */
+    std::vector<int> RandomNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+    std::vector<int> AgentBasedNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+    std::vector<int> IntersectionNeighborhood(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+};
+
+#endif // LNS_H
@@ -0,0 +1,225 @@
+#include "LaCAM.h"
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+ConfigurationArena::ConfigurationArena(int _agent_count)
+  : agent_count(_agent_count), size(0), slots(1024, -1) {}
+
+uint64_t ConfigurationArena::Hash(const int* config) const {
+  // splitmix64-style mixing of each cell index
+  uint64_t hash = 0x9e3779b97f4a7c15ULL;
+  for (int i = 0; i < agent_count; i++) {
+    uint64_t x = hash ^ (static_cast<uint64_t>(config[i]) + 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    hash = x ^ (x >> 31);
+  }
+  return hash;
+}
+
+int ConfigurationArena::Find(const int* config) const {
+  uint64_t hash = Hash(config);
+  size_t mask = slots.size() - 1;
+  for (size_t slot = hash & mask; slots[slot] != -1; slot = (slot + 1) & mask) {
+    int id = slots[slot];
+    if (hashes[id] == hash && std::memcmp(Get(id), config, sizeof(int) * agent_count) == 0) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+int ConfigurationArena::Insert(const int* config) {
+  // Keep the table at most half full
+  if (static_cast<size_t>(size + 1) * 2 > slots.size()) {
+    Grow();
+  }
+
+  uint64_t hash = Hash(config);
+  int id = size++;
+  configs.insert(configs.end(), config, config + agent_count);
+  hashes.push_back(hash);
+
+  size_t mask = slots.size() - 1;
+  size_t slot = hash & mask;
+  while (slots[slot] != -1) {
+    slot = (slot + 1) & mask;
+  }
+  slots[slot] = id;
+  return id;
+}
+
+void ConfigurationArena::Grow() {
+  slots.assign(slots.size() * 2, -1);
+  size_t mask = slots.size() - 1;
+  for (int id = 0; id < size; id++) {
+    size_t slot = hashes[id] & mask;
+    while (slots[slot] != -1) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = id;
+  }
+}
+
+LaCAM::LaCAM(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents)
+  : Solver(_map, _agents), time_limit(1.0), rng(0) {}
+
+void LaCAM::SetTimeLimit(double seconds) { time_limit = seconds; }
+void LaCAM::SetSeed(unsigned int seed) { rng.seed(seed); }
+
+int LaCAM::CreateNode(int config_id, int parent, const ConfigurationArena& arena, const std::vector<int>& goals) {
+  HighLevelNode node;
+  node.config_id = config_id;
+  node.parent = parent;
+
+  // Same priority rule as PIBT: grow while away from the goal, the fraction breaks ties
+  const int* config = arena.Get(config_id);
+  node.priorities.resize(agents.size());
+  if (parent == -1) {
+    std::uniform_real_distribution<float> tie(0.0f, 1.0f);
+    for (size_t i = 0; i < agents.size(); i++) {
+      node.priorities[i] = (config[i] == goals[i] ? 0.0f : 1.0f) + tie(rng);
+    }
+  } else {
+    const std::vector<float>& previous = nodes[parent].priorities;
+    for (size_t i = 0; i < agents.size(); i++) {
+      node.priorities[i] = config[i] == goals[i] ? previous[i] - std::floor(previous[i]) : previous[i] + 1.0f;
+    }
+  }
+
+  node.order.resize(agents.size());
+  std::iota(node.order.begin(), node.order.end(), 0);
+  std::sort(node.order.begin(), node.order.end(), [&node](int a, int b) {
+    return node.priorities[a] > node.priorities[b];
+  });
+
+  // Every node starts with the empty constraint
+  node.search_tree.push(0);
+
+  nodes.push_back(std::move(node));
+  return nodes.size() - 1;
+}
+
+bool LaCAM::PathFind() {
+  BeginPathFind();
+  auto start_time = std::chrono::steady_clock::now();
+  auto elapsed = [&start_time]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  };
+
+  PIBT pibt(map, agents);
+  pibt.SetSeed(rng());
+  if (!pibt.Initialize()) {
+    if (verbose) {
+      std::cerr << "No solution exists for at least one agent" << std::endl;
+    }
+    return false;
+  }
+  const std::vector<int>& goals = pibt.GetGoals();
+
+  nodes.clear();
+  constraints.clear();
+  constraints.push_back({-1, -1, -1, 0});
+
+  ConfigurationArena arena(agents.size());
+  std::vector<int> open = {CreateNode(arena.Insert(pibt.GetStarts().data()), -1, arena, goals)};
+
+  std::vector<int> current(agents.size());
+  std::vector<int> next(agents.size());
+  int goal_node = -1;
+  int iteration_count = 0;
+
+  while (!open.empty()) {
+    if ((++iteration_count & 63) == 0 && (elapsed() > time_limit || DeadlinePassed())) {
+      break;
+    }
+
+    int node_id = open.back();
+    const int* config = arena.Get(nodes[node_id].config_id);
+    if (std::equal(config, config + agents.size(), goals.begin())) {
+      goal_node = node_id;
+      break;
+    }
+
+    if (nodes[node_id].search_tree.empty()) {
+      open.pop_back();
+      continue;
+    }
+
+    int constraint_id = nodes[node_id].search_tree.front();
+    nodes[node_id].search_tree.pop();
+    stats.high_level_expanded++;
+
+    // Lazily add the constraints for the next agent in priority order
+    LowLevelNode constraint = constraints[constraint_id];
+    if (constraint.depth < static_cast<int>(agents.size())) {
+      int who = nodes[node_id].order[constraint.depth];
+      int from = config[who];
+      int moves[9];
+      int count = map->GetNeighborIds(from, moves);
+      moves[count++] = from;
+      std::shuffle(moves, moves + count, rng);
+      for (int k = 0; k < count; k++) {
+        constraints.push_back({constraint_id, who, moves[k], constraint.depth + 1});
+        nodes[node_id].search_tree.push(constraints.size() - 1);
+      }
+    }
+
+    // Generate a successor with PIBT, honouring the constraint chain
+    current.assign(config, config + agents.size());
+    std::fill(next.begin(), next.end(), -1);
+    for (int c = constraint_id; constraints[c].who != -1; c = constraints[c].parent) {
+      next[constraints[c].who] = constraints[c].where;
+    }
+    if (!pibt.Step(current, next, nodes[node_id].order)) {
+      continue;
+    }
+
+    // Configurations and high-level nodes are created together, so their ids match
+    int known = arena.Find(next.data());
+    if (known != -1) {
+      // Revisit the known configuration so it gets more constraints
+      open.push_back(known);
+      continue;
+    }
+
+    int child = CreateNode(arena.Insert(next.data()), node_id, arena, goals);
+    open.push_back(child);
+  }
+  stats.high_level_generated = static_cast<long long>(nodes.size());
+
+  if (goal_node == -1) {
+    if (verbose) {
+      if (open.empty()) {
+        std::cerr << "LaCAM proved that no solution exists" << std::endl;
+      } else if (timed_out) {
+        std::cerr << "LaCAM reached its deadline" << std::endl;
+      } else {
+        std::cerr << "LaCAM found no solution within " << time_limit << " seconds" << std::endl;
+      }
+    }
+    return false;
+  }
+
+  // Walk back to the start configuration
+  std::vector<std::vector<int>> configurations;
+  for (int id = goal_node; id != -1; id = nodes[id].parent) {
+    const int* config = arena.Get(nodes[id].config_id);
+    configurations.emplace_back(config, config + agents.size());
+  }
+  std::reverse(configurations.begin(), configurations.end());
+
+  auto solution = pibt.ToSolution(configurations);
+
+  // Publish the final solution to the map and the agents
+  ApplySolution(solution);
+
+  if (verbose) {
+    std::cout << "LaCAM explored " << arena.Size() << " configurations" << std::endl;
+    std::cout << "Solution found with cost: " << CalculateSolutionCost(solution) << std::endl;
+  }
+  return true;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file LaCAM.h
+ * @brief Defines the LaCAM configuration-space search engine.
+ *
+ * LaCAM (Lazy Constraints Addition search for MAPF) searches over joint
+ * configurations of all agents. Successors are generated lazily: each
+ * expansion asks PIBT for one next configuration, subject to a chain of
+ * low-level constraints that fix the moves of some agents. Revisiting a
+ * configuration adds more constraints, which makes the search complete.
+ */
+
+#ifndef LACAM_H
+#define LACAM_H
+
+#include <vector>
+#include <memory>
+#include <queue>
+#include <random>
+#include <cstdint>
+#include "Map.h"
+#include "Agent.h"
+#include "Solver.h"
+#include "PIBT.h"
+
+/**
+ * @brief Stores configurations back to back and finds duplicates by hash.
+ *
+ * Every configuration has the same length (one cell per agent), so entry k
+ * lives at offset k * agent_count of a single contiguous array. Lookups use
+ * an open-addressing table of entry ids.
+ */
+class ConfigurationArena {
+public:
+    /**
+     * @brief Constructs an empty arena.
+     *
+     * @param _agent_count Number of cells per configuration
+     */
+    explicit ConfigurationArena(int _agent_count);
+
+    /**
+     * @brief Finds a configuration.
+     *
+     * @param config Pointer to agent_count cell indices
+     * @return Entry id, or -1 if the configuration is not stored
+     */
+    int Find(const int* config) const;
+
+    /**
+     * @brief Stores a configuration that is not yet in the arena.
+     *
+     * @param config Pointer to agent_count cell indices
+     * @return Entry id of the new configuration
+     */
+    int Insert(const int* config);
+
+    /**
+     * @brief Gets a stored configuration.
+     *
+     * @param id Entry id
+     * @return Pointer to agent_count cell indices (invalidated by Insert)
+     */
+    const int* Get(int id) const { return &configs[static_cast<size_t>(id) * agent_count]; }
+
+    /**
+     * @brief Gets the number of stored configurations.
+     */
+    int Size() const { return size; }
+
+private:
+    int agent_count;                 ///< Cells per configuration
+    int size;                        ///< Number of stored configurations
+    std::vector<int> configs;        ///< All configurations, back to back
+    std::vector<uint64_t> hashes;    ///< Hash of every stored configuration
+    std::vector<int> slots;          ///< Open-addressing table of entry ids, -1 if empty
+
+    uint64_t Hash(const int* config) const;
+    void Grow();
+};
+
+/**
+ * @brief Implements LaCAM on top of PIBT.
+ */
+class LaCAM : public Solver {
+public:
+    /**
+     * @brief Constructs a new LaCAM solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    LaCAM(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Sets the wall-clock budget for the search.
+     *
+     * @param seconds Time limit in seconds
+     */
+    void SetTimeLimit(double seconds);
+
+    /**
+     * @brief Seeds the random successor ordering.
+     *
+     * @param seed Seed value
+     */
+    void SetSeed(unsigned int seed);
+
+    /**
+     * @brief Searches the configuration space until all agents are at their goals.
+     *
+     * @return true if a solution was found before the deadline
+     */
+    bool PathFind() override;
+
+private:
+    /**
+     * @brief A low-level constraint: agent `who` must move to `where`.
+     *
+     * Constraints form a tree; a node's full constraint set is the chain to the root.
+     */
+    struct LowLevelNode {
+        int parent;  ///< Index of the parent constraint, -1 for the empty root
+        int who;     ///< Constrained agent, -1 for the root
+        int where;   ///< Cell the agent must move to
+        int depth;   ///< Number of constraints in the chain
+    };
+
+    /**
+     * @brief A configuration reached by the search.
+     */
+    struct HighLevelNode {
+        int config_id;                  ///< Entry in the configuration arena
+        int parent;                     ///< Index of the parent node, -1 for the start
+        std::vector<float> priorities;  ///< PIBT priority of every agent
+        std::vector<int> order;         ///< Agents by decreasing priority
+        std::queue<int> search_tree;    ///< Low-level constraints still to try
+    };
+
+    double time_limit;                  ///< Wall-clock budget in seconds
+    std::mt19937 rng;                   ///< Random number generator
+    std::vector<LowLevelNode> constraints;  ///< All low-level constraint nodes
+    std::vector<HighLevelNode> nodes;       ///< All high-level nodes
+
+    /**
+     * @brief Creates a high-level node and sets its priorities and order.
+     *
+     * @param config_id Entry in the configuration arena
+     * @param parent Index of the parent node, -1 for the start
+     * @param arena Arena holding the configurations
+     * @param goals Goal cell of every agent
+     * @return Index of the new node
+     */
+    int CreateNode(int config_id, int parent, const ConfigurationArena& arena, const std::vector<int>& goals);
+};
+
+#endif // LACAM_H
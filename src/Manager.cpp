@@ -4,12 +4,13 @@
 const std::string Manager::SCENARIO_FOLDER_PATH = "../tests/scenarios/";
 
 // Constructor
-Manager::Manager() : map(nullptr), agents(), next_agent_id(0) {}
+Manager::Manager() : map(nullptr), agents(), next_agent_id(0), solver_type(SolverType::CBS), time_limit(1.0), max_iterations(0), path_cache_size(-1), cluster_size(0), quiet(false) {}
 
 // Initialize the map
 void Manager::InitializeMap(const std::string& _map_name) {
   try {
     map = std::make_shared<Map>(_map_name);
+    hierarchy.reset();
   } catch (const std::runtime_error& e) {
     std::cerr << "Error: " << e.what() << std::endl;
     throw;
@@ -25,58 +26,80 @@ void Manager::PrintMap() const {
   }
 }
 
-// Visualize the map in a window
-void Manager::VisualizeMap() const {
-  if (map) {
-    map->VisualizeMap();
-  } else {
-    std::cerr << "Error: Map is not initialized." << std::endl;
-  }
+std::shared_ptr<const Map> Manager::GetMap() const {
+  return map;
 }
 
-// Visualize the map in a window with a specific title
-void Manager::VisualizeMapWithTitle(const std::string& title) const {
-  if (map) {
-    map->VisualizeMapWithTitle(title);
-  } else {
-    std::cerr << "Error: Map is not initialized." << std::endl;
-  }
+std::shared_ptr<const Solver> Manager::GetSolver() const {
+  return solver;
 }
 
-// Initialize the Agent(s)
-void Manager::InitializeScenario(const std::string& _map_name, const std::string& _scenario_folder_name, const std::string& _scenario_name, const int agents_count) {
-    // Construct the full path to the scenario file
-    std::string folder_path = SCENARIO_FOLDER_PATH + _scenario_folder_name + "/" + _scenario_name + ".scen";
+const std::vector<std::shared_ptr<Agent>>& Manager::GetAgents() const {
+  return agents;
+}
 
-    // Open the scenario file
-    std::ifstream scenario_file(folder_path);
-    if (!scenario_file.is_open()) {
-        throw std::runtime_error("Failed to open scenario file: " + folder_path);
+// Read the agents of a scenario file
+std::vector<AgentData> Manager::ReadScenario(const std::string& path, int max_agents) {
+    // Map the scenario file
+    MappedFile scenario_file(path);
+    if (!scenario_file.IsOpen()) {
+        throw std::runtime_error("Failed to open scenario file: " + path);
     }
+    TextScanner scanner(scenario_file.Data(), scenario_file.Data() + scenario_file.Size());
 
     // Skip the header line
-    std::string line;
-    std::getline(scenario_file, line);
+    scanner.SkipLine();
 
-    // Read agents_count number of agents
-    while (next_agent_id < agents_count && std::getline(scenario_file, line)) {
-        std::istringstream line_stream(line);
+    std::vector<AgentData> entries;
+    if (max_agents >= 0) {
+        entries.reserve(max_agents);
+    }
+    std::string map_name;
+    const char* line;
+    size_t length;
+    int line_number = 1;
+    while ((max_agents < 0 || static_cast<int>(entries.size()) < max_agents) && scanner.NextLine(line, length)) {
+        line_number++;
+        if (length == 0) {
+            continue;  // Tolerate blank lines
+        }
+
+        // Parse the line
+        TextScanner fields(line, line + length);
         int bucket, height, width, start_x, start_y, goal_x, goal_y;
-        std::string map_name;
         double optimal_distance;
+        if (!fields.NextInt(bucket) || !fields.NextToken(map_name) || !fields.NextInt(height) ||
+            !fields.NextInt(width) || !fields.NextInt(start_x) || !fields.NextInt(start_y) ||
+            !fields.NextInt(goal_x) || !fields.NextInt(goal_y) || !fields.NextDouble(optimal_distance)) {
+            throw std::runtime_error("Malformed line " + std::to_string(line_number) + " in scenario file: " + path);
+        }
 
-        // Parse the line
-        line_stream >> bucket >> map_name >> height >> width >> start_x >> start_y >> goal_x >> goal_y >> optimal_distance;
+        entries.push_back({static_cast<int>(entries.size()), start_x, start_y, goal_x, goal_y, optimal_distance});
+    }
+
+    return entries;
+}
 
-        agents.push_back(std::make_shared<Agent>(next_agent_id, start_x, start_y, goal_x, goal_y, optimal_distance, map));
+// Initialize the Agent(s)
+void Manager::InitializeScenario(const std::string& _map_name, const std::string& _scenario_folder_name, const std::string& _scenario_name, const int agents_count) {
+    // Construct the full path to the scenario file
+    std::string folder_path = SCENARIO_FOLDER_PATH + _scenario_folder_name + "/" + _scenario_name + ".scen";
+
+    // Read agents_count number of agents
+    std::vector<AgentData> entries = ReadScenario(folder_path, std::max(0, agents_count - next_agent_id));
+    agents.reserve(agents_count);
+    for (const AgentData& entry : entries) {
+        agents.push_back(std::make_shared<Agent>(next_agent_id, entry.start_row, entry.start_col, entry.dest_row, entry.dest_col, entry.optimal_distance, map));
 
         // Print or store the agent data (for now, just print)
-        std::cout << std::fixed << std::setprecision(10)
-                  << "Agent " << next_agent_id + 1 << ":\n"
-                  << "  Start: (" << start_x << ", " << start_y << ")\n"
-                  << "  Goal: (" << goal_x << ", " << goal_y << ")\n"
-                  << "  Optimal Distance: " << optimal_distance << "\n"
-                  << std::endl;
+        if (!quiet) {
+            std::cout << std::fixed << std::setprecision(10)
+                      << "Agent " << next_agent_id + 1 << ":\n"
+                      << "  Start: (" << entry.start_row << ", " << entry.start_col << ")\n"
+                      << "  Goal: (" << entry.dest_row << ", " << entry.dest_col << ")\n"
+                      << "  Optimal Distance: " << entry.optimal_distance << "\n"
+                      << std::endl;
+        }
 
         // Increment the number of agents loaded
         next_agent_id++;
@@ -88,16 +111,190 @@ void Manager::InitializeScenario(const std::string& _map_name, const std::string
 
 }
 
+// Select the engine used for pathfinding
+void Manager::SetSolverType(SolverType type) {
+  solver_type = type;
+}
+
+SolverType Manager::ParseSolverType(const std::string& name) {
+  if (name == "cbs") return SolverType::CBS;
+  if (name == "pp") return SolverType::PRIORITIZED;
+  if (name == "pbs") return SolverType::PBS;
+  if (name == "lns") return SolverType::LNS;
+  if (name == "pibt") return SolverType::PIBT;
+  if (name == "lacam") return SolverType::LACAM;
+  if (name == "id") return SolverType::ID;
+  throw std::invalid_argument("Unknown engine: " + name);
+}
+
+void Manager::SetTimeLimit(double seconds) {
+  time_limit = seconds;
+}
+
+std::chrono::steady_clock::time_point Manager::GetDeadline() const {
+  return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                std::chrono::duration<double>(time_limit));
+}
+
+void Manager::SetMaxIterations(int iterations) {
+  max_iterations = iterations;
+}
+
+void Manager::SetPathCacheSize(int size) {
+  path_cache_size = size;
+}
+
+void Manager::SetClusterSize(int size) {
+  cluster_size = size;
+}
+
+void Manager::SetLandmarkCount(int count) {
+  if (!map) {
+    std::cerr << "Error: Map is not initialized." << std::endl;
+    return;
+  }
+  map->SetLandmarks(count);
+}
+
+void Manager::SetQuiet(bool _quiet) {
+  quiet = _quiet;
+}
+
 void Manager::StartPathfind() {
-  CBS cbs(map, agents);
-  cbs.PathFind();
+  solver = CreateSolver(agents, solver_type);
+  solver->SetDeadline(GetDeadline());
+  solver->PathFind();
+
+  MarkAgentPaths();
+}
+
+std::shared_ptr<Solver> Manager::CreateSolver(std::vector<std::shared_ptr<Agent>>& _agents, SolverType type) {
+  switch (type) {
+    case SolverType::PRIORITIZED:
+      return std::make_shared<PrioritizedPlanner>(map, _agents);
+    case SolverType::PBS:
+      return std::make_shared<PBS>(map, _agents);
+    case SolverType::LNS: {
+      auto lns = std::make_shared<LNS>(map, _agents);
+      lns->SetTimeLimit(time_limit);
+      return lns;
+    }
+    case SolverType::PIBT:
+      return std::make_shared<PIBT>(map, _agents);
+    case SolverType::LACAM: {
+      auto lacam = std::make_shared<LaCAM>(map, _agents);
+      lacam->SetTimeLimit(time_limit);
+      return lacam;
+    }
+    case SolverType::ID: {
+      auto id = std::make_shared<IndependenceDetection>(map, _agents);
+      // Groups are solved on worker threads, which may only read the manager
+      PrepareHierarchy();
+      id->SetGroupSetup([this](CBS& cbs) { ConfigureCBS(cbs); });
+      return id;
+    }
+    case SolverType::CBS:
+    default: {
+      auto cbs = std::make_shared<CBS>(map, _agents);
+      PrepareHierarchy();
+      ConfigureCBS(*cbs);
+      return cbs;
+    }
+  }
+}
+
+void Manager::ConfigureCBS(CBS& cbs) const {
+  if (max_iterations > 0) {
+    cbs.SetMaxIterations(max_iterations);
+  }
+  if (path_cache_size >= 0) {
+    cbs.SetPathCacheSize(path_cache_size);
+  }
+  if (cluster_size > 0) {
+    cbs.SetHierarchy(hierarchy);
+  }
+}
+
+std::vector<std::shared_ptr<Agent>> Manager::CreateAgents(const std::vector<AgentData>& entries) const {
+  if (!map) {
+    throw std::runtime_error("Map is not initialized");
+  }
+
+  auto usable = [&](int row, int col) { return map->IsInBounds(row, col) && map->IsPassable(map->GetIndex(row, col)); };
+  std::vector<std::shared_ptr<Agent>> created;
+  created.reserve(entries.size());
+  for (const AgentData& entry : entries) {
+    int id = static_cast<int>(created.size());
+    if (!usable(entry.start_row, entry.start_col) || !usable(entry.dest_row, entry.dest_col)) {
+      throw std::invalid_argument("Agent " + std::to_string(id) + " starts or ends outside the free cells of map " +
+                                  map->GetName());
+    }
+    created.push_back(std::make_shared<Agent>(id, entry.start_row, entry.start_col, entry.dest_row, entry.dest_col,
+                                              entry.optimal_distance, map));
+  }
+  return created;
+}
 
+void Manager::PrepareHierarchy() {
+  // Built once per map and shared by every search on it
+  if (cluster_size > 0 && (!hierarchy || hierarchy->GetClusterSize() != cluster_size)) {
+    hierarchy = std::make_shared<HierarchicalMap>(map, cluster_size);
+  }
+}
+
+std::vector<InstanceResult> Manager::RunBatch(const std::string& _scenario_folder_name, int first_count, int count_step, double instance_time_limit, int thread_count) {
+  if (!map) {
+    throw std::runtime_error("Map is not initialized");
+  }
+
+  // Workers create their solvers concurrently, so nothing may be built lazily from here on
+  PrepareHierarchy();
+  bool parallel = thread_count != 1;
+  BatchRunner runner(map, [this, parallel](std::vector<std::shared_ptr<Agent>>& instance_agents) {
+    std::shared_ptr<Solver> instance_solver = CreateSolver(instance_agents, solver_type);
+    if (auto id = std::dynamic_pointer_cast<IndependenceDetection>(instance_solver); id && parallel) {
+      id->SetThreadCount(1);  // The batch already keeps every core busy
+    }
+    return instance_solver;
+  });
+  runner.SetAgentSweep(first_count, count_step);
+  runner.SetTimeLimit(instance_time_limit);
+  runner.SetThreadCount(thread_count);
+  return runner.RunFolder(SCENARIO_FOLDER_PATH + _scenario_folder_name);
+}
+
+bool Manager::PreprocessMap() const {
+  if (!map) {
+    std::cerr << "Error: Map is not initialized." << std::endl;
+    return false;
+  }
+
+  // One table per distinct goal
+  std::vector<int> goals;
+  std::unordered_set<int> seen;
+  for (const auto& agent : agents) {
+    const AgentData& data = agent->GetAgentData();
+    int goal = map->GetIndex(data.dest_row, data.dest_col);
+    if (seen.insert(goal).second) {
+      goals.push_back(goal);
+    }
+  }
+
+  std::string path = Map::GetPreprocessedPath(map->GetName());
+  if (!map->SavePreprocessed(path, goals)) {
+    return false;
+  }
+  std::cout << "Wrote " << path << " with " << goals.size() << " distance tables" << std::endl;
+  return true;
+}
+
+void Manager::MarkAgentPaths() {
   // Loop through all agents
   for (size_t i = 0; i < agents.size(); ++i) {
     auto& agent = agents[i];
     
     // Determine the icon for this agent
-    char icon;
+    char icon = '*';
     if (i < 26) {
       // A-Z for first 26 agents
       icon = 'A' + static_cast<char>(i);
@@ -106,9 +303,88 @@ void Manager::StartPathfind() {
     // Loop through the agent's path and set the icon
     for (auto& cell : agent->GetPath()) {
       if (cell) {
-        cell->icon = icon;
+        map->MarkIcon(cell->row, cell->col, icon);
       }
     }
   }
 }
 
+void Manager::SetGoalProvider(GoalProvider provider) {
+  goal_provider = std::move(provider);
+}
+
+bool Manager::RunRollingHorizon(int window, int replan_period, int cycles) {
+  replan_period = std::max(1, std::min(replan_period, window));
+
+  // Executed trajectory of every agent, starting at its current position
+  std::vector<std::vector<std::shared_ptr<Cell>>> executed(agents.size());
+  for (size_t i = 0; i < agents.size(); i++) {
+    const AgentData& data = agents[i]->GetAgentData();
+    executed[i].push_back(map->GetCell(data.start_row, data.start_col));
+  }
+
+  int arrivals = 0;
+  int cycle = 0;
+  bool failed = false;
+  for (; cycle < cycles; cycle++) {
+    // Hand out new goals to agents that have arrived
+    bool all_done = true;
+    for (auto& agent : agents) {
+      AgentData& data = agent->GetAgentData();
+      if (data.start_row == data.dest_row && data.start_col == data.dest_col) {
+        int row, col;
+        if (goal_provider && goal_provider(data.agent_id, row, col)) {
+          agent->SetGoal(row, col);
+          all_done = false;
+        }
+      } else {
+        all_done = false;
+      }
+    }
+    if (all_done) {
+      break;
+    }
+
+    auto cbs = std::make_shared<CBS>(map, agents);
+    cbs->SetWindow(window);
+    cbs->SetPublishSolution(false);
+    if (max_iterations > 0) {
+      cbs->SetMaxIterations(max_iterations);
+    }
+    if (path_cache_size >= 0) {
+      cbs->SetPathCacheSize(path_cache_size);
+    }
+    cbs->SetDeadline(GetDeadline());
+    solver = cbs;
+    if (!cbs->PathFind()) {
+      std::cerr << "Rolling horizon stopped: CBS failed in cycle " << cycle << std::endl;
+      failed = true;
+      break;
+    }
+
+    // Execute the first steps of the plan
+    const auto& plan = cbs->GetSolution();
+    for (size_t i = 0; i < agents.size(); i++) {
+      const auto& path = plan[i];
+      for (int t = 1; t <= replan_period; t++) {
+        executed[i].push_back(path[std::min<size_t>(t, path.size() - 1)]);
+      }
+
+      const auto& position = executed[i].back();
+      AgentData& data = agents[i]->GetAgentData();
+      bool was_at_goal = data.start_row == data.dest_row && data.start_col == data.dest_col;
+      agents[i]->SetStart(position->row, position->col);
+      if (!was_at_goal && position->row == data.dest_row && position->col == data.dest_col) {
+        arrivals++;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < agents.size(); i++) {
+    agents[i]->SetPath(executed[i]);
+  }
+  MarkAgentPaths();
+
+  std::cout << "Rolling horizon: " << cycle << " cycles, " << arrivals << " goal arrivals" << std::endl;
+  return !failed;
+}
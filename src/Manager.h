@@ -18,10 +18,33 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <functional>
+#include <chrono>
 
 #include "Map.h"
 #include "Agent.h"
+#include "MappedFile.h"
 #include "CBS.h"
+#include "PrioritizedPlanner.h"
+#include "PBS.h"
+#include "LNS.h"
+#include "PIBT.h"
+#include "LaCAM.h"
+#include "IndependenceDetection.h"
+#include "BatchRunner.h"
+
+/**
+ * @brief Selects the engine used to plan paths.
+ */
+enum class SolverType {
+    CBS,          ///< Optimal Conflict-Based Search
+    PRIORITIZED,  ///< Prioritized planning with a reservation table
+    PBS,          ///< Priority-Based Search over priority orderings
+    LNS,          ///< Anytime Large Neighborhood Search
+    PIBT,         ///< Priority Inheritance with Backtracking, one step at a time
+    LACAM,        ///< Complete configuration-space search driven by PIBT
+    ID            ///< Independence Detection, CBS per group of interacting agents
+};
 
 /**
  * @brief Manages the coordination of pathfinding operations.
@@ -30,7 +53,7 @@
  * - Loading and managing the map
  * - Creating and managing agents
  * - Coordinating pathfinding operations
- * - Visualizing results
+ * - Benchmarking an engine over whole scenario folders
  */
 class Manager {
   public:
@@ -77,16 +100,25 @@ class Manager {
     void PrintMap() const;
 
     /**
-     * @brief Visualizes the current state of the map in a window.
+     * @brief Gets the loaded map, e.g. to draw it.
+     * 
+     * @return The map, or nullptr before InitializeMap()
      */
-    void VisualizeMap() const;
+    std::shared_ptr<const Map> GetMap() const;
 
     /**
-     * @brief Visualizes the map with a custom title.
+     * @brief Gets the engine of the last StartPathfind(), e.g. to read its statistics.
      * 
-     * @param title Title to display in the visualization window
+     * @return The solver, or nullptr before the first run
      */
-    void VisualizeMapWithTitle(const std::string& title) const;
+    std::shared_ptr<const Solver> GetSolver() const;
+
+    /**
+     * @brief Gets the agents of the scenario, with their paths after a run.
+     * 
+     * @return The agents in scenario order
+     */
+    const std::vector<std::shared_ptr<Agent>>& GetAgents() const;
 
     /**
      * @brief Initializes the map with a given name.
@@ -98,6 +130,9 @@ class Manager {
     /**
      * @brief Initializes a scenario with specified parameters.
      * 
+     * The scenario file is memory-mapped and parsed in place. Unless quiet
+     * mode is on, every loaded agent is printed.
+     * 
      * @param _map_name Name of the map
      * @param _scenario_folder_name Name of the scenario folder
      * @param _scenario_name Name of the scenario
@@ -108,16 +143,216 @@ class Manager {
                           const std::string& _scenario_name, 
                           const int agents_count);
 
+    /**
+     * @brief Reads the start, goal and optimal distance of the agents in a scenario file.
+     * 
+     * @param path Path to the `.scen` file
+     * @param max_agents Stop after this many agents, negative to read all
+     * @return One entry per agent, with IDs in file order
+     * @throw std::runtime_error if the file cannot be opened or a line is malformed
+     */
+    static std::vector<AgentData> ReadScenario(const std::string& path, int max_agents = -1);
+
+    /**
+     * @brief Selects the engine used by StartPathfind.
+     * 
+     * @param type Engine to use
+     */
+    void SetSolverType(SolverType type);
+
+    /**
+     * @brief Converts an engine name ("cbs", "pp", "pbs", "lns", "pibt", "lacam", "id") to a solver type.
+     * 
+     * @param name Engine name
+     * @return The matching solver type
+     * @throw std::invalid_argument if the name is unknown
+     */
+    static SolverType ParseSolverType(const std::string& name);
+
+    /**
+     * @brief Sets the wall-clock budget of every engine.
+     * 
+     * StartPathfind() stops the engine at this deadline, and rolling-horizon
+     * planning stops each replan at it. LNS uses the whole budget to
+     * improve its solution, and LaCAM takes it as its search budget.
+     * 
+     * @param seconds Time limit in seconds
+     */
+    void SetTimeLimit(double seconds);
+
+    /**
+     * @brief Sets the node expansion limit of CBS.
+     * 
+     * Bounds the planning time of each rolling-horizon cycle.
+     * 
+     * @param iterations Node expansion limit, 0 for the engine default
+     */
+    void SetMaxIterations(int iterations);
+
+    /**
+     * @brief Sets how many low-level paths CBS memoizes per search.
+     * 
+     * @param size Cache capacity in paths, 0 to disable, -1 for the engine default
+     */
+    void SetPathCacheSize(int size);
+
+    /**
+     * @brief Plans CBS root paths over an HPA* abstraction of the map.
+     * 
+     * @param size Side length of a cluster in cells, 0 to plan roots with A*
+     */
+    void SetClusterSize(int size);
+
+    /**
+     * @brief Switches the map's heuristic to landmark distances.
+     * 
+     * Builds the landmarks on the loaded map right away; a preprocessed map
+     * that already has this many landmarks is used as is.
+     * 
+     * @param count Number of landmarks, 0 for the plain grid heuristic
+     */
+    void SetLandmarkCount(int count);
+
+    /**
+     * @brief Gets the engine used by StartPathfind().
+     */
+    SolverType GetSolverType() const { return solver_type; }
+
+    /**
+     * @brief Creates an engine with the current settings.
+     * 
+     * Only reads the manager once PrepareHierarchy() has run, so several
+     * threads can create solvers for the same map at the same time.
+     * 
+     * @param _agents Agents to plan for; must outlive the solver
+     * @param type Engine to create
+     * @return The configured solver
+     */
+    std::shared_ptr<Solver> CreateSolver(std::vector<std::shared_ptr<Agent>>& _agents, SolverType type);
+
+    /**
+     * @brief Builds the HPA* abstraction if a cluster size is set and it does not exist yet.
+     */
+    void PrepareHierarchy();
+
+    /**
+     * @brief Creates agents on the loaded map without adding them to the manager.
+     * 
+     * Only reads the map, so several threads can create agents at once.
+     * 
+     * @param entries Start and goal of each agent; agent IDs become their positions
+     * @return One agent per entry
+     * @throw std::invalid_argument if a start or goal is outside the map or blocked
+     */
+    std::vector<std::shared_ptr<Agent>> CreateAgents(const std::vector<AgentData>& entries) const;
+
+    /**
+     * @brief Turns off the per-agent printing of InitializeScenario().
+     * 
+     * @param _quiet true to load scenarios silently
+     */
+    void SetQuiet(bool _quiet);
+
     /**
      * @brief Starts the pathfinding process for all agents.
      */
     void StartPathfind();
 
+    /**
+     * @brief Benchmarks the selected engine on every scenario of a folder.
+     * 
+     * The loaded map is shared by all instances. Each scenario is solved
+     * with `first_count`, `first_count + count_step`, ... agents until an
+     * instance fails or reaches the time limit. Scenarios run in parallel
+     * on `thread_count` workers.
+     * 
+     * @param _scenario_folder_name Name of the scenario folder
+     * @param first_count Smallest agent count
+     * @param count_step Increase of the agent count between instances
+     * @param instance_time_limit Deadline of each instance in seconds
+     * @param thread_count Number of worker threads, 0 for one per hardware thread
+     * @return One result per instance
+     * @throw std::runtime_error if the folder or a scenario cannot be read
+     */
+    std::vector<InstanceResult> RunBatch(const std::string& _scenario_folder_name, int first_count,
+                                         int count_step, double instance_time_limit, int thread_count = 1);
+
+    /**
+     * @brief Writes the preprocessed binary form of the map next to its `.map` file.
+     * 
+     * Includes the map's landmarks and the distance tables of the loaded
+     * agents' goals, so later runs of the same scenario skip both parsing
+     * and the searches behind the heuristics.
+     * 
+     * @return true if the file was written
+     */
+    bool PreprocessMap() const;
+
+    /**
+     * @brief Callback that hands out the next goal of an agent.
+     * 
+     * Receives the agent ID and writes the new goal. Returns false if the
+     * agent has no further goals.
+     */
+    using GoalProvider = std::function<bool(int agent_id, int& row, int& col)>;
+
+    /**
+     * @brief Sets where agents get new goals from during rolling-horizon planning.
+     * 
+     * Without a provider, agents stay at their goal once they reach it.
+     * 
+     * @param provider Callback asked whenever an agent reaches its goal
+     */
+    void SetGoalProvider(GoalProvider provider);
+
+    /**
+     * @brief Plans and executes paths with windowed CBS in a rolling horizon.
+     * 
+     * Every cycle, CBS keeps the next `window` time steps conflict-free, the
+     * agents execute the first `replan_period` steps, and planning restarts
+     * from their new positions. Stops when all agents are at their goals
+     * with no new goals, or after `cycles` cycles. The executed trajectories
+     * become the agents' paths.
+     * 
+     * @param window Time steps kept conflict-free per cycle
+     * @param replan_period Time steps executed per cycle (at most the window)
+     * @param cycles Maximum number of cycles
+     * @return false if CBS failed in some cycle
+     */
+    bool RunRollingHorizon(int window, int replan_period, int cycles);
+
   private:
     std::shared_ptr<Map> map;                    ///< Shared pointer to the map
     std::vector<std::shared_ptr<Agent>> agents;  ///< Vector of agent pointers
     int next_agent_id;                           ///< Next available agent ID
-    std::shared_ptr<CBS> cbs_solver;            ///< Shared pointer to the CBS solver
+    SolverType solver_type;                      ///< Engine used by StartPathfind
+    double time_limit;                           ///< Time limit of every engine (seconds)
+    int max_iterations;                          ///< CBS node expansion limit, 0 for the default
+    int path_cache_size;                         ///< CBS path cache capacity, -1 for the default
+    int cluster_size;                            ///< HPA* cluster size for CBS root paths, 0 for none
+    bool quiet;                                  ///< Whether scenario loading prints the agents
+    std::shared_ptr<Solver> solver;              ///< Shared pointer to the active solver
+    GoalProvider goal_provider;                  ///< Source of new goals for rolling-horizon planning
+    std::shared_ptr<const HierarchicalMap> hierarchy;  ///< HPA* abstraction of the map, built on first use
+
+    /**
+     * @brief Marks every agent's path on the map with the agent's icon.
+     */
+    void MarkAgentPaths();
+
+    /**
+     * @brief Applies the CBS settings (iteration limit, path cache, HPA* hierarchy) to a search.
+     * 
+     * Only reads the manager; PrepareHierarchy() must have run.
+     * 
+     * @param cbs Search to configure
+     */
+    void ConfigureCBS(CBS& cbs) const;
+
+    /**
+     * @brief Gets the deadline of a search that starts now.
+     */
+    std::chrono::steady_clock::time_point GetDeadline() const;
 };
 
 #endif // MANAGER_H
\ No newline at end of file
@@ -1,8 +1,64 @@
 #include "Map.h"
+#include "OccupancyTable.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
 
 // Define the map folder path
 const std::string Map::MAP_FOLDER_PATH = "../tests/maps/";
 
+const int Map::UNREACHABLE = std::numeric_limits<int>::max();
+
+const uint32_t Map::PREPROCESSED_VERSION = 2;
+
+namespace {
+
+// Moves in neighbor bit order: cardinal directions first, then diagonals
+const int DIRECTIONS[8][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+const char PREPROCESSED_MAGIC[8] = {'M', 'A', 'P', 'F', 'B', 'I', 'N', '\0'};
+
+// Fixed-size header at the start of a .mapbin file
+struct PreprocessedHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t movement_type;
+  int32_t height;
+  int32_t width;
+  uint64_t source_checksum;  // HashBytes of the .map file
+  uint32_t table_count;      // Number of stored distance tables
+  uint32_t landmark_count;   // Number of stored landmarks
+};
+
+static_assert(sizeof(int) == sizeof(int32_t), "Distance tables are stored as 32-bit integers");
+
+// Byte offsets of the sections that follow the header
+struct PreprocessedLayout {
+  size_t terrain;       // One character per cell
+  size_t bitmap;        // One passability bit per cell
+  size_t masks;         // One neighbor mask per cell
+  size_t counts;        // One neighbor count per cell
+  size_t landmarks;     // Landmark indices, 4-byte aligned
+  size_t landmark_distances;  // Cell-major landmark distances
+  size_t tables;        // Distance tables
+  size_t table_stride;  // Goal index followed by one distance per cell
+  size_t total;
+
+  PreprocessedLayout(size_t cell_count, size_t table_count, size_t landmark_count) {
+    terrain = sizeof(PreprocessedHeader);
+    bitmap = terrain + cell_count;
+    masks = bitmap + (cell_count + 7) / 8;
+    counts = masks + cell_count;
+    landmarks = (counts + cell_count + 3) / 4 * 4;
+    landmark_distances = landmarks + landmark_count * sizeof(int32_t);
+    tables = landmark_distances + cell_count * landmark_count * sizeof(int32_t);
+    table_stride = (cell_count + 1) * sizeof(int32_t);
+    total = tables + table_count * table_stride;
+  }
+};
+
+}  // namespace
+
 Cell::Cell(int _r, int _c, char _icon) : row(_r), col(_c), icon(_icon) {}
 
 // Check if the cell is an obstacle
@@ -10,66 +66,30 @@ bool Cell::IsObstacle() const {
   return icon == '@';
 }
 
-// Check if the cell is occupied at a specific time
-bool Cell::IsOccupiedAtTime(int time) const {
-  return occupancy_map.find(time) != occupancy_map.end() && !occupancy_map.at(time).empty();
-}
-
-// Occupy the cell at a specific time with a given agent
-void Cell::Occupy(int time, int agent_id) {
-  occupancy_map[time].push_back(agent_id);
-}
-
-// Free the cell at a specific time for an agent
-void Cell::Free(int time, int agent_id) {
-  if (occupancy_map.find(time) != occupancy_map.end()) {
-    std::deque<int>& agents_at_time = occupancy_map[time];
-    std::deque<int> temp_queue;
-    
-    // Remove the specific agent (FIFO behavior)
-    bool found = false;
-    while (!agents_at_time.empty()) {
-      int current_agent = agents_at_time.front();
-      agents_at_time.pop_front();
-      
-      if (current_agent == agent_id && !found) {
-        found = true; // Skip the agent being freed
-      } else {
-        temp_queue.push_back(current_agent); // Keep the others in the queue
-      }
-    }
-
-    // Restore the modified queue
-    occupancy_map[time] = temp_queue;
-
-    // Clean up if no agents are left at this time
-    if (occupancy_map[time].empty()) {
-      occupancy_map.erase(time);
-    }
-  }
-}
-
 Map::Map(const std::string& _map_name) : map_name(_map_name) {
   std::string full_path = MAP_FOLDER_PATH + _map_name + ".map";
+  if (LoadPreprocessed(GetPreprocessedPath(_map_name), full_path)) {
+    return;
+  }
   if (!InitializeMap(full_path)) {
     throw std::runtime_error("Failed to initialize map from file: " + _map_name);
   }
 }
 
 bool Map::InitializeMap(const std::string& file_path) {
-  std::ifstream file(file_path);
-  if (!file.is_open()) {
+  MappedFile file(file_path);
+  if (!file.IsOpen()) {
     std::cerr << "Error: Could not open map file: " << file_path << std::endl;
     return false;
   }
-
-  std::string line;
+  source_checksum = HashBytes(file.Data(), file.Size());
+  TextScanner scanner(file.Data(), file.Data() + file.Size());
 
   // Get map type
-  std::getline(file, line);
-  std::istringstream type_stream(line);
   std::string type_label;
-  type_stream >> type_label >> type_label;  // Read the label twice if needed
+  scanner.NextToken(type_label);
+  scanner.NextToken(type_label);  // The label follows the "type" keyword
+  scanner.SkipLine();
 
   // Determine movement type based on the type_label
   if (type_label == "octile") {
@@ -82,90 +102,581 @@ bool Map::InitializeMap(const std::string& file_path) {
     movement_type = MovementType::MANHATTAN; // Default or error handling
   }
 
-
   // Get map height
-  std::getline(file, line);
-  std::istringstream height_stream(line);
   std::string height_label;
-  height_stream >> height_label >> map_height;
-  if (height_label != "height" || map_height <= 0) {
+  if (!scanner.NextToken(height_label) || height_label != "height" ||
+      !scanner.NextInt(map_height) || map_height <= 0) {
     std::cerr << "Error: Invalid height in map file." << std::endl;
     return false;
   }
+  scanner.SkipLine();
 
   // Get map width
-  std::getline(file, line);
-  std::istringstream width_stream(line);
   std::string width_label;
-  width_stream >> width_label >> map_width;
-  if (width_label != "width" || map_width <= 0) {
+  if (!scanner.NextToken(width_label) || width_label != "width" ||
+      !scanner.NextInt(map_width) || map_width <= 0) {
     std::cerr << "Error: Invalid width in map file." << std::endl;
     return false;
   }
+  scanner.SkipLine();
 
   // Read "map" line (fourth line)
-  std::getline(file, line);
-  if (line != "map") {
+  const char* line;
+  size_t length;
+  if (!scanner.NextLine(line, length) || std::string(line, length) != "map") {
     std::cerr << "Error: Expected 'map' line." << std::endl;
     return false;
   }
 
-  // Read grid data
-  grid.resize(map_height, std::vector<std::shared_ptr<Cell>>(map_width));
+  // Copy grid data row by row from the mapped file into the flat terrain array
+  terrain.resize(GetCellCount());
   for (int row = 0; row < map_height; ++row) {
-    std::getline(file, line);
-    if (line.length() != static_cast<size_t>(map_width)) {
+    if (!scanner.NextLine(line, length) || length != static_cast<size_t>(map_width)) {
       std::cerr << "Error: Map width mismatch at line " << row + 1 << std::endl;
       return false;
     }
-    for (int col = 0; col < map_width; ++col) {
-      grid[row][col] = std::make_shared<Cell>(row, col, line[col]); // Initialize each cell with its icon
+    std::copy(line, line + length, terrain.begin() + GetIndex(row, 0));
+  }
+  icons = terrain;
+  agent_icons.clear();
+
+  BuildFlatGrid();
+  return true;
+}
+
+std::string Map::GetPreprocessedPath(const std::string& _map_name) {
+  return MAP_FOLDER_PATH + _map_name + ".mapbin";
+}
+
+bool Map::SavePreprocessed(const std::string& file_path, const std::vector<int>& goal_indices) const {
+  int cell_count = GetCellCount();
+  for (int goal : goal_indices) {
+    if (goal < 0 || goal >= cell_count) {
+      std::cerr << "Error: Goal index " << goal << " is outside the map." << std::endl;
+      return false;
+    }
+  }
+
+  std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Error: Could not create preprocessed map file: " << file_path << std::endl;
+    return false;
+  }
+
+  PreprocessedHeader header = {};
+  std::memcpy(header.magic, PREPROCESSED_MAGIC, sizeof(header.magic));
+  header.version = PREPROCESSED_VERSION;
+  header.movement_type = static_cast<uint32_t>(movement_type);
+  header.height = map_height;
+  header.width = map_width;
+  header.source_checksum = source_checksum;
+  header.table_count = static_cast<uint32_t>(goal_indices.size());
+  header.landmark_count = static_cast<uint32_t>(landmark_indices.size());
+  PreprocessedLayout layout(cell_count, goal_indices.size(), landmark_indices.size());
+
+  std::vector<uint8_t> bitmap(layout.masks - layout.bitmap, 0);
+  for (int index = 0; index < cell_count; ++index) {
+    bitmap[index / 8] |= passable[index] << (index % 8);
+  }
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(terrain.data(), cell_count);
+  file.write(reinterpret_cast<const char*>(bitmap.data()), bitmap.size());
+  file.write(reinterpret_cast<const char*>(neighbor_masks.data()), cell_count);
+  file.write(reinterpret_cast<const char*>(neighbor_counts.data()), cell_count);
+  const char padding[4] = {};
+  file.write(padding, layout.landmarks - (layout.counts + cell_count));
+  file.write(reinterpret_cast<const char*>(landmark_indices.data()), landmark_indices.size() * sizeof(int32_t));
+  file.write(reinterpret_cast<const char*>(landmark_distances.data()), landmark_distances.size() * sizeof(int32_t));
+  for (int goal : goal_indices) {
+    int32_t goal_index = goal;
+    file.write(reinterpret_cast<const char*>(&goal_index), sizeof(goal_index));
+    file.write(reinterpret_cast<const char*>(GetDistanceTable(goal).get()), cell_count * sizeof(int32_t));
+  }
+
+  if (!file) {
+    std::cerr << "Error: Failed to write preprocessed map file: " << file_path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool Map::LoadPreprocessed(const std::string& file_path, const std::string& source_path) {
+  auto mapping = std::make_shared<const MappedFile>(file_path);
+  const MappedFile& file = *mapping;
+  if (!file.IsOpen()) {
+    return false;  // Not preprocessed, the caller parses the map file
+  }
+
+  PreprocessedHeader header;
+  if (file.Size() < sizeof(header)) {
+    std::cerr << "Warning: Ignoring truncated preprocessed map: " << file_path << std::endl;
+    return false;
+  }
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.magic, PREPROCESSED_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != PREPROCESSED_VERSION) {
+    std::cerr << "Warning: Ignoring preprocessed map with another format version: " << file_path << std::endl;
+    return false;
+  }
+
+  MappedFile source(source_path);
+  if (!source.IsOpen() || HashBytes(source.Data(), source.Size()) != header.source_checksum) {
+    std::cerr << "Warning: Ignoring stale preprocessed map, " << source_path << " changed: " << file_path << std::endl;
+    return false;
+  }
+
+  if (header.height <= 0 || header.width <= 0 ||
+      header.movement_type > static_cast<uint32_t>(MovementType::OCTILE)) {
+    std::cerr << "Warning: Ignoring corrupt preprocessed map: " << file_path << std::endl;
+    return false;
+  }
+  size_t cell_count = static_cast<size_t>(header.height) * header.width;
+  PreprocessedLayout layout(cell_count, header.table_count, header.landmark_count);
+  if (file.Size() != layout.total) {
+    std::cerr << "Warning: Ignoring truncated preprocessed map: " << file_path << std::endl;
+    return false;
+  }
+
+  // Goals and landmarks index the cell arrays, so a bad one must not get through
+  const char* data = file.Data();
+  auto in_map = [cell_count](int32_t index) { return index >= 0 && static_cast<size_t>(index) < cell_count; };
+  for (uint32_t table = 0; table < header.table_count; ++table) {
+    int32_t goal;
+    std::memcpy(&goal, data + layout.tables + table * layout.table_stride, sizeof(goal));
+    if (!in_map(goal)) {
+      std::cerr << "Warning: Ignoring corrupt preprocessed map: " << file_path << std::endl;
+      return false;
+    }
+  }
+  for (uint32_t k = 0; k < header.landmark_count; ++k) {
+    int32_t landmark;
+    std::memcpy(&landmark, data + layout.landmarks + k * sizeof(int32_t), sizeof(landmark));
+    if (!in_map(landmark)) {
+      std::cerr << "Warning: Ignoring corrupt preprocessed map: " << file_path << std::endl;
+      return false;
     }
   }
 
+  // The grid arrays are copied out, since SetPassable() edits them
+  movement_type = static_cast<MovementType>(header.movement_type);
+  map_height = header.height;
+  map_width = header.width;
+  source_checksum = header.source_checksum;
+
+  terrain.assign(data + layout.terrain, data + layout.terrain + cell_count);
+  icons = terrain;
+  agent_icons.clear();
+
+  passable.resize(cell_count);
+  const uint8_t* bitmap = reinterpret_cast<const uint8_t*>(data + layout.bitmap);
+  for (size_t index = 0; index < cell_count; ++index) {
+    passable[index] = bitmap[index / 8] >> (index % 8) & 1u;
+  }
+  neighbor_masks.assign(data + layout.masks, data + layout.masks + cell_count);
+  neighbor_counts.assign(data + layout.counts, data + layout.counts + cell_count);
+  InitializeDirections();
+
+  landmark_indices.resize(header.landmark_count);
+  std::memcpy(landmark_indices.data(), data + layout.landmarks, landmark_indices.size() * sizeof(int32_t));
+  landmark_distances.resize(cell_count * header.landmark_count);
+  std::memcpy(landmark_distances.data(), data + layout.landmark_distances, landmark_distances.size() * sizeof(int32_t));
+
+  // The goal tables are the bulk of the file; they are read in place, and
+  // sections start at multiples of 4 bytes, so the ints are aligned
+  std::lock_guard<std::mutex> lock(distance_mutex);
+  distance_tables.clear();
+  for (uint32_t table = 0; table < header.table_count; ++table) {
+    const char* entry = data + layout.tables + table * layout.table_stride;
+    int32_t goal;
+    std::memcpy(&goal, entry, sizeof(goal));
+    distance_tables[goal].mapped = reinterpret_cast<const int*>(entry + sizeof(goal));
+  }
+  preprocessed_file = std::move(mapping);
   return true;
 }
 
+void Map::InitializeDirections() {
+  // One bit per direction, in the same order as GetNeighbors
+  max_degree = movement_type == MovementType::OCTILE ? 8 : 4;
+  offset_masks.assign(2 * map_width + 3, 0);
+  for (int k = 0; k < max_degree; ++k) {
+    direction_offsets[k] = DIRECTIONS[k][0] * map_width + DIRECTIONS[k][1];
+    offset_masks[direction_offsets[k] + map_width + 1] |= 1u << k;  // Narrow maps give some directions one offset
+  }
+}
+
+void Map::BuildFlatGrid() {
+  int cell_count = GetCellCount();
+
+  passable.assign(cell_count, 0);
+  for (int index = 0; index < cell_count; ++index) {
+    passable[index] = terrain[index] == '@' ? 0 : 1;
+  }
+
+  InitializeDirections();
+  neighbor_masks.assign(cell_count, 0);
+  neighbor_counts.assign(cell_count, 0);
+
+  // One pass per direction over the cells whose neighbor in that direction is in bounds
+  for (int k = 0; k < max_degree; ++k) {
+    int row_begin = std::max(0, -DIRECTIONS[k][0]);
+    int row_end = map_height - std::max(0, DIRECTIONS[k][0]);
+    int col_begin = std::max(0, -DIRECTIONS[k][1]);
+    int col_end = map_width - std::max(0, DIRECTIONS[k][1]);
+    for (int row = row_begin; row < row_end; ++row) {
+      for (int index = GetIndex(row, col_begin), last = GetIndex(row, col_end); index < last; ++index) {
+        neighbor_masks[index] |= passable[index + direction_offsets[k]] << k;
+      }
+    }
+  }
+  for (int index = 0; index < cell_count; ++index) {
+    for (unsigned int mask = neighbor_masks[index]; mask != 0; mask &= mask - 1) {
+      neighbor_counts[index]++;
+    }
+  }
+
+  landmark_indices.clear();
+  landmark_distances.clear();
+
+  std::lock_guard<std::mutex> lock(distance_mutex);
+  distance_tables.clear();
+  preprocessed_file.reset();
+}
+
+int Map::GetCellCount() const { return map_width * map_height; }
+
+std::shared_ptr<const int[]> Map::ShareTable(const CachedTable& table) const {
+  // Aliasing pointers: holders keep the vector or the whole mapping alive
+  if (table.owned) {
+    return std::shared_ptr<const int[]>(table.owned, table.owned->data());
+  }
+  return std::shared_ptr<const int[]>(preprocessed_file, table.mapped);
+}
+
+std::shared_ptr<const int[]> Map::GetCachedDistanceTable(int goal_index) const {
+  std::lock_guard<std::mutex> lock(distance_mutex);
+  auto it = distance_tables.find(goal_index);
+  return it != distance_tables.end() ? ShareTable(it->second) : nullptr;
+}
+
+std::shared_ptr<const int[]> Map::GetDistanceTable(int goal_index) const {
+  {
+    std::lock_guard<std::mutex> lock(distance_mutex);
+    auto it = distance_tables.find(goal_index);
+    if (it != distance_tables.end()) {
+      return ShareTable(it->second);
+    }
+  }
+
+  // Moves are symmetric, so distances from the goal are distances to it
+  auto distances = std::make_shared<std::vector<int>>(GetCellCount());
+  ComputeDistances(goal_index, distances->data());
+
+  std::lock_guard<std::mutex> lock(distance_mutex);
+  return ShareTable(distance_tables.emplace(goal_index, CachedTable{std::move(distances)}).first->second);
+}
+
+void Map::ComputeDistances(int source, int* distances) const {
+  std::fill(distances, distances + GetCellCount(), UNREACHABLE);
+  if (!IsPassable(source)) {
+    return;
+  }
+
+  std::vector<int> frontier(GetCellCount());
+  size_t head = 0, tail = 0;
+  frontier[tail++] = source;
+  distances[source] = 0;
+  while (head < tail) {
+    int current = frontier[head++];
+    int next_distance = distances[current] + 1;
+    int neighbors[8];
+    for (int k = 0, count = GetNeighborIds(current, neighbors); k < count; ++k) {
+      int neighbor = neighbors[k];
+      if (distances[neighbor] == UNREACHABLE) {
+        distances[neighbor] = next_distance;
+        frontier[tail++] = neighbor;
+      }
+    }
+  }
+}
+
+bool Map::SetPassable(int row, int col, bool _passable) {
+  if (!IsInBounds(row, col)) {
+    std::cerr << "Error: Cell (" << row << ", " << col << ") is outside the map." << std::endl;
+    return false;
+  }
+  int index = GetIndex(row, col);
+  if (IsPassable(index) == _passable) {
+    return true;
+  }
+
+  terrain[index] = _passable ? '.' : '@';
+  icons[index] = terrain[index];
+  passable[index] = _passable ? 1 : 0;
+  source_checksum = 0;
+
+  // Only the cell and the neighbors that point at it change adjacency
+  UpdateNeighbors(index);
+  for (int k = 0; k < max_degree; ++k) {
+    int neighbor_row = row + DIRECTIONS[k][0];
+    int neighbor_col = col + DIRECTIONS[k][1];
+    if (IsInBounds(neighbor_row, neighbor_col)) {
+      UpdateNeighbors(GetIndex(neighbor_row, neighbor_col));
+    }
+  }
+
+  for (int k = 0; k < GetLandmarkCount(); ++k) {
+    RepairDistances(landmark_distances.data() + k, landmark_indices.size(), landmark_indices[k], index);
+  }
+
+  std::lock_guard<std::mutex> lock(distance_mutex);
+  for (auto& [goal, table] : distance_tables) {
+    if (!table.owned) {
+      table.owned = std::make_shared<std::vector<int>>(table.mapped, table.mapped + GetCellCount());  // The mapping is read-only
+      table.mapped = nullptr;
+    } else if (table.owned.use_count() > 1) {
+      table.owned = std::make_shared<std::vector<int>>(*table.owned);  // Someone still reads it; they keep the old copy
+    }
+    RepairDistances(table.owned->data(), 1, goal, index);
+  }
+  return true;
+}
+
+void Map::UpdateNeighbors(int index) {
+  int row = GetRow(index);
+  int col = GetCol(index);
+  uint8_t mask = 0;
+  for (int k = 0; k < max_degree; ++k) {
+    int neighbor_row = row + DIRECTIONS[k][0];
+    int neighbor_col = col + DIRECTIONS[k][1];
+    if (IsInBounds(neighbor_row, neighbor_col) && passable[GetIndex(neighbor_row, neighbor_col)]) {
+      mask |= 1u << k;
+    }
+  }
+  neighbor_masks[index] = mask;
+  neighbor_counts[index] = 0;
+  for (unsigned int bits = mask; bits != 0; bits &= bits - 1) {
+    neighbor_counts[index]++;
+  }
+}
+
+void Map::RepairDistances(int* distances, size_t stride, int source, int changed) const {
+  auto at = [distances, stride](int index) -> int& { return distances[index * stride]; };
+  int neighbors[8];
+
+  if (IsPassable(changed)) {
+    // Unblocked: the cell may offer shorter routes, which only ever spread outwards from it
+    int best = changed == source ? 0 : UNREACHABLE;
+    for (int k = 0, count = GetNeighborIds(changed, neighbors); k < count; ++k) {
+      if (at(neighbors[k]) != UNREACHABLE) {
+        best = std::min(best, at(neighbors[k]) + 1);
+      }
+    }
+    at(changed) = best;
+    if (best == UNREACHABLE) {
+      return;
+    }
+
+    std::vector<int> frontier = {changed};
+    for (size_t head = 0; head < frontier.size(); ++head) {
+      int current = frontier[head];
+      for (int k = 0, count = GetNeighborIds(current, neighbors); k < count; ++k) {
+        if (at(current) + 1 < at(neighbors[k])) {
+          at(neighbors[k]) = at(current) + 1;
+          frontier.push_back(neighbors[k]);
+        }
+      }
+    }
+    return;
+  }
+
+  // Blocked: nothing depended on a cell that was already unreachable
+  int old_distance = at(changed);
+  at(changed) = UNREACHABLE;
+  if (old_distance == UNREACHABLE) {
+    return;
+  }
+  if (changed == source) {
+    for (int index = 0; index < GetCellCount(); ++index) {
+      at(index) = UNREACHABLE;
+    }
+    return;
+  }
+
+  // Layer by layer, find the cells whose every neighbor one move closer to the source was lost.
+  // Lost cells are reset right away, so a later check only counts the neighbors that remain.
+  std::vector<std::pair<int, int>> lost = {{changed, old_distance}};  // Cell and its old distance
+  for (size_t head = 0; head < lost.size(); ++head) {
+    int next_distance = lost[head].second + 1;
+    for (int k = 0, count = GetNeighborIds(lost[head].first, neighbors); k < count; ++k) {
+      int candidate = neighbors[k];
+      if (at(candidate) != next_distance) {
+        continue;
+      }
+
+      bool supported = false;
+      int candidate_neighbors[8];
+      for (int j = 0, candidate_count = GetNeighborIds(candidate, candidate_neighbors); j < candidate_count && !supported; ++j) {
+        supported = at(candidate_neighbors[j]) == next_distance - 1;
+      }
+      if (!supported) {
+        at(candidate) = UNREACHABLE;
+        lost.push_back({candidate, next_distance});
+      }
+    }
+  }
+
+  // Reconnect the lost cells through their remaining neighbors, nearest first
+  using Entry = std::pair<int, int>;  // Distance, cell
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_set;
+  for (size_t i = 1; i < lost.size(); ++i) {
+    int cell = lost[i].first;
+    for (int k = 0, count = GetNeighborIds(cell, neighbors); k < count; ++k) {
+      if (at(neighbors[k]) != UNREACHABLE && at(neighbors[k]) + 1 < at(cell)) {
+        at(cell) = at(neighbors[k]) + 1;
+      }
+    }
+    if (at(cell) != UNREACHABLE) {
+      open_set.push({at(cell), cell});
+    }
+  }
+  while (!open_set.empty()) {
+    auto [distance, current] = open_set.top();
+    open_set.pop();
+    if (distance > at(current)) {
+      continue;  // Stale entry
+    }
+    for (int k = 0, count = GetNeighborIds(current, neighbors); k < count; ++k) {
+      if (distance + 1 < at(neighbors[k])) {
+        at(neighbors[k]) = distance + 1;
+        open_set.push({distance + 1, neighbors[k]});
+      }
+    }
+  }
+}
+
+void Map::SetLandmarks(int count) {
+  int cell_count = GetCellCount();
+  count = std::max(0, count);
+  if (count == GetLandmarkCount()) {
+    return;
+  }
+  landmark_indices.clear();
+  landmark_distances.assign(static_cast<size_t>(cell_count) * count, UNREACHABLE);
+  if (count == 0) {
+    return;
+  }
+
+  // Seed the selection from a cell with all neighbors free, so it is not in an isolated pocket
+  int seed = -1;
+  for (int index = 0; index < cell_count && (seed < 0 || neighbor_counts[seed] < max_degree); ++index) {
+    if (passable[index] && (seed < 0 || neighbor_counts[index] > neighbor_counts[seed])) {
+      seed = index;
+    }
+  }
+  if (seed < 0) {
+    landmark_distances.clear();
+    return;  // No passable cells
+  }
+
+  // Farthest-point selection; closest holds each cell's distance to the nearest landmark so far
+  std::vector<int> distances(cell_count);
+  ComputeDistances(seed, distances.data());
+  std::vector<int> closest(cell_count, UNREACHABLE);
+  for (int k = 0; k < count; ++k) {
+    const std::vector<int>& reference = k == 0 ? distances : closest;
+    int landmark = -1;
+    for (int index = 0; index < cell_count; ++index) {
+      if (distances[index] != UNREACHABLE && (landmark < 0 || reference[index] > reference[landmark])) {
+        landmark = index;
+      }
+    }
+    if (landmark < 0 || (k > 0 && closest[landmark] == 0)) {
+      break;  // Every reachable cell is already a landmark
+    }
+
+    std::vector<int> from_landmark(cell_count);
+    ComputeDistances(landmark, from_landmark.data());
+    landmark_indices.push_back(landmark);
+    for (int index = 0; index < cell_count; ++index) {
+      landmark_distances[static_cast<size_t>(index) * count + k] = from_landmark[index];
+      closest[index] = std::min(closest[index], from_landmark[index]);
+    }
+  }
+
+  // Fewer landmarks than asked for: repack with the smaller stride
+  int found = GetLandmarkCount();
+  if (found < count) {
+    std::vector<int> packed(static_cast<size_t>(cell_count) * found);
+    for (int index = 0; index < cell_count; ++index) {
+      std::copy_n(&landmark_distances[static_cast<size_t>(index) * count], found, &packed[static_cast<size_t>(index) * found]);
+    }
+    landmark_distances = std::move(packed);
+  }
+}
+
+int Map::LandmarkHeuristic(int index, int goal_index) const {
+  int count = GetLandmarkCount();
+  const int* from_cell = landmark_distances.data() + static_cast<size_t>(index) * count;
+  const int* from_goal = landmark_distances.data() + static_cast<size_t>(goal_index) * count;
+  int bound = 0;
+  for (int k = 0; k < count; ++k) {
+    if (from_cell[k] != UNREACHABLE && from_goal[k] != UNREACHABLE) {
+      bound = std::max(bound, std::abs(from_goal[k] - from_cell[k]));
+    }
+  }
+  return bound;
+}
+
 std::shared_ptr<Cell> Map::GetCell(int row, int col) const {
   if (IsInBounds(row, col)) {
-    return grid[row][col];
+    return std::make_shared<Cell>(row, col, icons[GetIndex(row, col)]);
   }
   return nullptr;
 }
 
-void Map::PrintMap() const {
-  for (const auto& row : grid) {
-    for (const auto& cell : row) {
-      std::cout << cell->icon;
+void Map::MarkIcon(int row, int col, char icon) {
+  int index = GetIndex(row, col);
+  icons[index] = icon;
+  if (icon >= 'A' && icon <= 'Z') {
+    if (agent_icons.empty()) {
+      agent_icons.assign(GetCellCount(), 0);
     }
+    agent_icons[index] |= 1u << (icon - 'A');
+  }
+}
+
+void Map::ClearIcons() {
+  icons = terrain;
+  agent_icons.clear();
+}
+
+void Map::PrintMap() const {
+  for (int row = 0; row < map_height; ++row) {
+    std::cout.write(&icons[GetIndex(row, 0)], map_width);
     std::cout << std::endl;
   }
 }
 
 bool Map::IsObstacle(int row, int col) const {
-  return grid[row][col]->IsObstacle();  // Return true if the cell is an obstacle
+  return passable[GetIndex(row, col)] == 0;  // Return true if the cell is an obstacle
 }
 
 bool Map::IsOccupied(int row, int col, int time) const {
-  if (!IsInBounds(row, col)) {
-    return false;
-  }
-
-  // Check if the cell is occupied at the given time
-  return grid[row][col]->occupancy_map.find(time) != grid[row][col]->occupancy_map.end();
+  return GetAgentAt(row, col, time) != -1;
 }
 
 int Map::GetAgentAt(int row, int col, int time) const {
-  if (!IsInBounds(row, col)) {
-    return -1;  // Return -1 if the position is out of bounds
+  if (!IsInBounds(row, col) || !occupancy) {
+    return -1;  // Return -1 if the position is out of bounds or nothing was published
   }
 
-  // Check if the cell has an agent occupying it at the given time
-  auto it = grid[row][col]->occupancy_map.find(time);
-  if (it != grid[row][col]->occupancy_map.end()) {
-    return it->second.front();  // Return the agent ID at that time
-  }
-  return -1;
+  return occupancy->GetAgentAt(GetIndex(row, col), time);
+}
+
+void Map::SetOccupancy(std::shared_ptr<const OccupancyTable> table) {
+  occupancy = std::move(table);
 }
 
 bool Map::IsInBounds(int row, int col) const {
@@ -204,15 +715,18 @@ double Map::Heuristic(int row1, int col1, int row2, int col2) const {
   int drow = std::abs(row2 - row1);
   int dcol = std::abs(col2 - col1);
 
+  double grid_distance = 0.0;
   if (movement_type == MovementType::MANHATTAN) {
-    return drow + dcol; // Manhattan distance
-  }
-  
-  if (movement_type == MovementType::OCTILE) {
-    return std::max(drow, dcol) + (std::sqrt(2) - 1) * std::min(drow, dcol); // Octile distance
+    grid_distance = drow + dcol; // Manhattan distance
+  } else if (movement_type == MovementType::OCTILE) {
+    grid_distance = std::max(drow, dcol) + (std::sqrt(2) - 1) * std::min(drow, dcol); // Octile distance
   }
 
-  return 0.0; // Default case
+  // Every move costs at least 1, so the landmark move count bounds the cost too
+  if (!landmark_indices.empty()) {
+    return std::max(grid_distance, static_cast<double>(LandmarkHeuristic(GetIndex(row1, col1), GetIndex(row2, col2))));
+  }
+  return grid_distance;
 }
 
 // Returns a list of valid neighboring cells for (row, col)
@@ -242,70 +756,6 @@ std::vector<std::pair<int, int>> Map::GetNeighbors(int row, int col) const {
   return neighbors;
 }
 
-void Map::VisualizeMap() const {
-  VisualizeMapWithTitle("Map Visualization");
-}
-
-void Map::VisualizeMapWithTitle(const std::string& title) const {
-  const int cellSize = 20; // Size of each cell in pixels
-  sf::RenderWindow window(sf::VideoMode(map_width * cellSize, map_height * cellSize), title);
-
-  std::unordered_map<char, sf::Color> colorMap = {
-      {'.', sf::Color::White},
-      {'@', sf::Color::Black},
-      {'A', sf::Color::Red},
-      {'B', sf::Color::Blue},
-      {'C', sf::Color::Green},
-      {'D', sf::Color::Yellow},
-      {'E', sf::Color::Magenta},
-      {'F', sf::Color::Cyan} // Add more mappings as needed
-  };
-
-  while (window.isOpen()) {
-    sf::Event event;
-    while (window.pollEvent(event)) {
-      if (event.type == sf::Event::Closed)
-        window.close();
-    }
-
-    window.clear();
-    for (int row = 0; row < map_height; ++row) {
-      for (int col = 0; col < map_width; ++col) {
-        sf::RectangleShape cellShape(sf::Vector2f(cellSize, cellSize));
-        cellShape.setPosition(col * cellSize, row * cellSize);
-
-        const std::unordered_set<char>& icons = grid[row][col]->icons;
-        char icon = grid[row][col]->icon;
-        
-        if (icon == '.' || icon == '@') {
-          cellShape.setFillColor(colorMap[icon]);
-        }
-        else if (!icons.empty()) {
-          int totalR = 0, totalG = 0, totalB = 0;
-          for (char icon : icons) {
-            if (colorMap.find(icon) != colorMap.end()) {
-              sf::Color color = colorMap[icon];
-              totalR += color.r;
-              totalG += color.g;
-              totalB += color.b;
-            }
-          }
-          int count = icons.size();
-          sf::Color blendedColor(totalR / count, totalG / count, totalB / count);
-          cellShape.setFillColor(blendedColor);
-        } else {
-          cellShape.setFillColor(sf::Color::Green); // Default color for unknown characters
-        }
-
-        cellShape.setOutlineColor(sf::Color::Black);
-        cellShape.setOutlineThickness(1);
-        window.draw(cellShape);
-      }
-    }
-
-    window.display();
-  }
-}
-
 int Map::GetWidth() const { return map_width; }
-int Map::GetHeight() const { return map_height; }
\ No newline at end of file
+int Map::GetHeight() const { return map_height; }
+MovementType Map::GetMovementType() const { return movement_type; }
\ No newline at end of file
@@ -22,21 +22,23 @@
 #include <memory>
 #include <queue>
 #include <unordered_set>
-#include <deque>
-#include <SFML/Graphics.hpp>
+#include <mutex>
+#include <limits>
+#include <cstdint>
 
 /**
  * @brief Represents a single cell in the grid map.
  * 
- * Each cell contains information about its position, visual representation,
- * and occupancy status at different time steps.
+ * A cell is a small view of one grid square, built on demand by
+ * Map::GetCell(). The map itself keeps terrain and icons in flat arrays,
+ * so changing a cell's icon goes through Map::MarkIcon(), not the view.
+ * Which agent is in a cell at a given time is answered by the map's
+ * OccupancyTable.
  */
 struct Cell {
   int row;  ///< Row coordinate in the grid
   int col;  ///< Column coordinate in the grid
-  char icon;  ///< Visual representation of the cell ('.', '@', etc)
-  std::unordered_set<char> icons;  ///< Set of icons for cells with multiple agents
-  std::unordered_map<int, std::deque<int>> occupancy_map;  ///< Time -> queue of agent_ids (FIFO)
+  char icon;  ///< Icon of the cell when the view was built ('.', '@', agent letter, ...)
 
   /**
    * @brief Constructs a new Cell object.
@@ -53,32 +55,11 @@ struct Cell {
    * @return true if the cell is an obstacle ('@'), false otherwise
    */
   bool IsObstacle() const;
-
-  /**
-   * @brief Checks if the cell is occupied at a specific time step.
-   * 
-   * @param time The time step to check
-   * @return true if the cell is occupied at the given time
-   */
-  bool IsOccupiedAtTime(int time) const;
-
-  /**
-   * @brief Marks the cell as occupied by an agent at a specific time.
-   * 
-   * @param time The time step
-   * @param agent_id The ID of the occupying agent
-   */
-  void Occupy(int time, int agent_id);
-
-  /**
-   * @brief Removes an agent's occupation from the cell at a specific time.
-   * 
-   * @param time The time step
-   * @param agent_id The ID of the agent to remove
-   */
-  void Free(int time, int agent_id);
 };
 
+class OccupancyTable;
+class MappedFile;
+
 /**
  * @brief Defines the movement types supported by the map.
  */
@@ -91,16 +72,23 @@ enum class MovementType {
  * @brief Represents a grid-based map for pathfinding.
  * 
  * The Map class manages a 2D grid of cells and provides functionality for
- * pathfinding, collision detection, and visualization.
+ * pathfinding and collision detection. Drawing it is left to Visualizer,
+ * so the map has no graphics dependency.
  */
 class Map {
   public:
     /// Path to the folder containing map files
     static const std::string MAP_FOLDER_PATH;
 
+    /// Version of the preprocessed map format, bumped on every layout change
+    static const uint32_t PREPROCESSED_VERSION;
+
     /**
      * @brief Constructs a new Map object from a map file.
      * 
+     * If a preprocessed `<name>.mapbin` file built from the same `.map` file
+     * sits next to it, the map is loaded from that instead.
+     * 
      * @param _map_name Name of the map file (without extension)
      * @throw std::runtime_error if map initialization fails
      */
@@ -114,6 +102,49 @@ class Map {
      */
     bool InitializeMap(const std::string& file_path);
 
+    /**
+     * @brief Gets the path of the preprocessed file of a map.
+     * 
+     * @param _map_name Name of the map (without extension)
+     * @return Path of `<name>.mapbin` in the map folder
+     */
+    static std::string GetPreprocessedPath(const std::string& _map_name);
+
+    /**
+     * @brief Writes the map in the preprocessed binary format.
+     * 
+     * The file holds the terrain, a passability bitmap, the neighbor masks
+     * and counts, the landmarks, and the distance tables of the given goals, after a header
+     * with the format version and the checksum of the source `.map` file.
+     * Values are stored in native byte order.
+     * 
+     * @param file_path Output path
+     * @param goal_indices Flat indices of the goals whose distance tables are stored
+     * @return false if the file could not be written
+     */
+    bool SavePreprocessed(const std::string& file_path, const std::vector<int>& goal_indices) const;
+
+    /**
+     * @brief Loads the map from a preprocessed file.
+     * 
+     * The file is mapped once. The grid arrays and landmarks are copied out,
+     * while the goal distance tables stay in the mapping, which the map keeps
+     * open while any table points into it. The file is rejected if its
+     * version differs from PREPROCESSED_VERSION, if it is truncated, if the
+     * source map file changed since it was written, or if a goal or landmark
+     * lies outside the map.
+     * 
+     * @param file_path Path to the preprocessed file
+     * @param source_path Path to the `.map` file it was built from
+     * @return true if the map was loaded
+     */
+    bool LoadPreprocessed(const std::string& file_path, const std::string& source_path);
+
+    /**
+     * @brief Gets the name of the map.
+     */
+    const std::string& GetName() const { return map_name; }
+
     /**
      * @brief Checks if a cell is an obstacle.
      * 
@@ -123,9 +154,28 @@ class Map {
      */
     bool IsObstacle(int row, int col) const;
 
+    /**
+     * @brief Blocks or unblocks a cell at runtime.
+     * 
+     * Updates the terrain and the adjacency of the cell and its neighbors,
+     * and repairs every cached distance table and the landmark distances
+     * in place: only the cells whose distance actually changes are
+     * visited. Lazy tables held by running solvers and HierarchicalMap
+     * instances built earlier are not updated. The map no longer matches
+     * its file, so a preprocessed copy saved afterwards is treated as stale.
+     * 
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @param passable true to make the cell free, false to make it an obstacle
+     * @return false if the coordinates are out of bounds
+     */
+    bool SetPassable(int row, int col, bool passable);
+
     /**
      * @brief Checks if a cell is occupied at a specific time.
      * 
+     * Answers from the occupancy table of the last published solution.
+     * 
      * @param row Row coordinate
      * @param col Column coordinate
      * @param time Time step
@@ -143,6 +193,15 @@ class Map {
      */
     int GetAgentAt(int row, int col, int time) const;
 
+    /**
+     * @brief Replaces the occupancy table queried by IsOccupied() and GetAgentAt().
+     * 
+     * Called when a solver publishes a solution; searches leave it untouched.
+     * 
+     * @param table Occupancy of the published solution, nullptr for none
+     */
+    void SetOccupancy(std::shared_ptr<const OccupancyTable> table);
+
     /**
      * @brief Checks if coordinates are within map bounds.
      * 
@@ -155,12 +214,52 @@ class Map {
     /**
      * @brief Gets a cell at specified coordinates.
      * 
+     * Builds a new view of the cell; views of the same square are equal by
+     * row and column, not by pointer.
+     * 
      * @param row Row coordinate
      * @param col Column coordinate
      * @return Shared pointer to the cell, or nullptr if out of bounds
      */
     std::shared_ptr<Cell> GetCell(int row, int col) const;
 
+    /**
+     * @brief Gets the icon shown for a cell.
+     * 
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @return The terrain character, or the last icon marked on the cell
+     */
+    char GetIcon(int row, int col) const { return icons[GetIndex(row, col)]; }
+
+    /**
+     * @brief Gets the agent letters marked on a cell.
+     * 
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @return Bit k set if letter 'A' + k was marked since the last ClearIcons()
+     */
+    uint32_t GetAgentIcons(int row, int col) const {
+      return agent_icons.empty() ? 0 : agent_icons[GetIndex(row, col)];
+    }
+
+    /**
+     * @brief Shows an icon on a cell, e.g. an agent letter along its path.
+     * 
+     * Agent letters 'A' to 'Z' are also collected per cell, so the
+     * visualizer can blend the colors of several agents sharing a cell.
+     * 
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @param icon Icon to show
+     */
+    void MarkIcon(int row, int col, char icon);
+
+    /**
+     * @brief Resets every cell's icon to its terrain character.
+     */
+    void ClearIcons();
+
     /**
      * @brief Gets valid neighboring cells for pathfinding.
      * 
@@ -184,30 +283,50 @@ class Map {
     /**
      * @brief Calculates heuristic cost between two cells.
      * 
+     * Once landmarks are set, this is the larger of the grid distance and
+     * the differential bound from LandmarkHeuristic(), which sees walls.
+     * 
      * @param row1 Start row
      * @param col1 Start column
      * @param row2 End row
      * @param col2 End column
-     * @return Heuristic cost (Manhattan or Octile distance)
+     * @return Heuristic cost (Manhattan or Octile distance, or the landmark bound)
      */
     double Heuristic(int row1, int col1, int row2, int col2) const;
 
     /**
-     * @brief Prints the map to console.
+     * @brief Picks landmark cells and computes their distance arrays.
+     * 
+     * Landmarks are chosen by farthest-point selection: each new landmark
+     * is the reachable cell farthest from all landmarks chosen so far.
+     * Memory is count × cells distances, independent of the number of goals.
+     * Nothing is recomputed if the map already has that many landmarks.
+     * 
+     * @param count Number of landmarks, 0 to go back to the grid heuristic
      */
-    void PrintMap() const;
+    void SetLandmarks(int count);
 
     /**
-     * @brief Opens a window to visualize the map.
+     * @brief Gets the number of landmarks in use.
      */
-    void VisualizeMap() const;
+    int GetLandmarkCount() const { return static_cast<int>(landmark_indices.size()); }
 
     /**
-     * @brief Opens a window to visualize the map with a custom title.
+     * @brief Lower bound on the number of moves between two cells from the landmarks.
      * 
-     * @param title Window title
+     * By the triangle inequality, max over landmarks L of |d(L, goal) - d(L, cell)|.
+     * Landmarks that cannot reach both cells are skipped.
+     * 
+     * @param index Flat index of the cell
+     * @param goal_index Flat index of the goal
+     * @return The bound, 0 without landmarks
      */
-    void VisualizeMapWithTitle(const std::string& title) const;
+    int LandmarkHeuristic(int index, int goal_index) const;
+
+    /**
+     * @brief Prints the map to console.
+     */
+    void PrintMap() const;
 
     /**
      * @brief Gets the map width.
@@ -223,12 +342,192 @@ class Map {
      */
     int GetHeight() const;
 
+    /**
+     * @brief Gets the movement type of the map.
+     * 
+     * @return MANHATTAN or OCTILE
+     */
+    MovementType GetMovementType() const;
+
+    /// Distance stored for cells that cannot reach the goal
+    static const int UNREACHABLE;
+
+    /**
+     * @brief Gets the number of cells in the flat grid.
+     * 
+     * @return Width times height
+     */
+    int GetCellCount() const;
+
+    /**
+     * @brief Converts coordinates to a flat row-major cell index.
+     * 
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @return Cell index
+     */
+    int GetIndex(int row, int col) const { return row * map_width + col; }
+
+    /**
+     * @brief Gets the row of a flat cell index.
+     */
+    int GetRow(int index) const { return index / map_width; }
+
+    /**
+     * @brief Gets the column of a flat cell index.
+     */
+    int GetCol(int index) const { return index % map_width; }
+
+    /**
+     * @brief Checks if a flat cell index is passable.
+     * 
+     * @param index Cell index
+     * @return true if the cell is not an obstacle
+     */
+    bool IsPassable(int index) const { return passable[index] != 0; }
+
+    /**
+     * @brief Gets the number of passable neighbors of a cell.
+     * 
+     * @param index Cell index
+     * @return Neighbor count
+     */
+    int GetNeighborCount(int index) const { return neighbor_counts[index]; }
+
+    /**
+     * @brief Gets the passable neighbors of a cell as flat indices.
+     * 
+     * Each cell stores one bit per direction; the indices are rebuilt from
+     * the direction offsets, in the same order as GetNeighbors().
+     * 
+     * @param index Cell index
+     * @param neighbors Output buffer with room for GetMaxDegree() indices
+     * @return Number of neighbors written, equal to GetNeighborCount(index)
+     */
+    int GetNeighborIds(int index, int* neighbors) const {
+      int count = 0;
+      for (unsigned int mask = neighbor_masks[index], k = 0; mask != 0; mask >>= 1, k++) {
+        if (mask & 1u) neighbors[count++] = index + direction_offsets[k];
+      }
+      return count;
+    }
+
+    /**
+     * @brief Checks if a cell is reached from another one by a single move.
+     * 
+     * @param index Cell index
+     * @param other Cell index of the possible neighbor
+     * @return true if other is a passable neighbor of index
+     */
+    bool IsNeighbor(int index, int other) const {
+      const size_t slot = static_cast<size_t>(other - index + map_width + 1);
+      return slot < offset_masks.size() && (neighbor_masks[index] & offset_masks[slot]) != 0;
+    }
+
+    /**
+     * @brief Gets the largest possible number of neighbors of a cell (4 or 8).
+     */
+    int GetMaxDegree() const { return max_degree; }
+
+    /**
+     * @brief Gets the number of moves from every cell to a goal.
+     * 
+     * Tables are computed by breadth-first search on first use and cached,
+     * so agents sharing a goal share a table. Safe to call from several threads.
+     * 
+     * @param goal_index Flat index of the goal cell
+     * @return Move counts indexed by cell, UNREACHABLE where the goal cannot be reached
+     */
+    std::shared_ptr<const int[]> GetDistanceTable(int goal_index) const;
+
+    /**
+     * @brief Gets a distance table only if it was already computed.
+     * 
+     * @param goal_index Flat index of the goal cell
+     * @return The cached table, or nullptr if none exists yet
+     */
+    std::shared_ptr<const int[]> GetCachedDistanceTable(int goal_index) const;
+
+    /**
+     * @brief Fills an array with the number of moves from a source cell by breadth-first search.
+     * 
+     * Unlike GetDistanceTable() nothing is cached, so callers that visit
+     * many sources can reuse one buffer.
+     * 
+     * @param source Flat index of the source cell
+     * @param distances Output with room for GetCellCount() entries
+     */
+    void ComputeDistances(int source, int* distances) const;
+
   private:
-    std::vector<std::vector<std::shared_ptr<Cell>>> grid;  ///< 2D grid of cells
     std::string map_name;                ///< Name of the map
+    uint64_t source_checksum = 0;        ///< Hash of the `.map` file the map was loaded from
     int map_height;                      ///< Height of the map
     int map_width;                       ///< Width of the map
     MovementType movement_type;          ///< Movement type (Manhattan or Octile)
+    std::shared_ptr<const OccupancyTable> occupancy;  ///< Occupancy of the published solution
+
+    std::vector<char> terrain;           ///< Row-major terrain characters as read from the map file
+    std::vector<char> icons;             ///< Row-major icon shown for each cell
+    std::vector<uint32_t> agent_icons;   ///< Row-major bit set of agent letters marked on each cell, empty until first used
+    std::vector<uint8_t> passable;       ///< Row-major passability (1 = free)
+    std::vector<uint8_t> neighbor_masks; ///< Row-major bit k set if direction k leads to a passable cell
+    std::vector<uint8_t> neighbor_counts;  ///< Number of passable neighbors per cell
+    int direction_offsets[8] = {};       ///< Flat index offset of each direction
+    std::vector<uint8_t> offset_masks;   ///< Directions with each offset from -(width + 1) to width + 1
+    int max_degree = 0;                  ///< Number of directions
+
+    std::vector<int> landmark_indices;   ///< Flat indices of the landmark cells
+    std::vector<int> landmark_distances; ///< Cell-major: entry index * landmark count + k is the distance from landmark k
+
+    /**
+     * @brief Cached distances to one goal.
+     *
+     * Computed tables own their storage. Tables loaded from a preprocessed
+     * file point into preprocessed_file until SetPassable() copies them to
+     * repair them.
+     */
+    struct CachedTable {
+        std::shared_ptr<std::vector<int>> owned;  ///< Distances, if owned
+        const int* mapped = nullptr;              ///< Distances in preprocessed_file, if not owned
+    };
+
+    mutable std::mutex distance_mutex;   ///< Guards distance_tables and preprocessed_file
+    mutable std::unordered_map<int, CachedTable> distance_tables;  ///< goal -> distances
+    std::shared_ptr<const MappedFile> preprocessed_file;  ///< Mapping the loaded tables point into
+
+    /**
+     * @brief Hands out a cached table, keeping its storage alive.
+     */
+    std::shared_ptr<const int[]> ShareTable(const CachedTable& table) const;
+
+    /**
+     * @brief Restores the distances from a source after a cell changed passability.
+     * 
+     * Distances are read and written at distances[index * stride], so the
+     * same repair serves goal tables and the cell-major landmark array.
+     * 
+     * @param distances First distance of the array
+     * @param stride Entries between the distances of consecutive cells
+     * @param source Flat index of the cell distances are measured from
+     * @param changed Flat index of the cell that was blocked or unblocked
+     */
+    void RepairDistances(int* distances, size_t stride, int source, int changed) const;
+
+    /**
+     * @brief Recomputes the neighbor mask and count of one cell.
+     */
+    void UpdateNeighbors(int index);
+
+    /**
+     * @brief Sets the number of directions and their index offsets from the movement type.
+     */
+    void InitializeDirections();
+
+    /**
+     * @brief Builds the flat passability and adjacency arrays from the terrain.
+     */
+    void BuildFlatGrid();
 };
 
 #endif // MAP_H
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "MappedFile.h"
+#include <cmath>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return;
+  }
+  size = static_cast<size_t>(file.tellg());
+  char* buffer = new char[size > 0 ? size : 1];
+  file.seekg(0);
+  file.read(buffer, size);
+  data = buffer;
+  is_open = true;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == 0) {
+    size = static_cast<size_t>(info.st_size);
+    is_open = true;
+    if (size > 0) {
+      void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        is_open = false;
+        size = 0;
+      } else {
+        data = static_cast<const char*>(mapped);
+        is_mapped = true;
+      }
+    }
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  delete[] data;
+#else
+  if (is_mapped) {
+    munmap(const_cast<char*>(data), size);
+  }
+#endif
+}
+
+uint64_t HashBytes(const char* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+void TextScanner::SkipBlanks() {
+  while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+    pos++;
+  }
+}
+
+void TextScanner::SkipLine() {
+  while (pos < end && *pos != '\n') {
+    pos++;
+  }
+  if (pos < end) {
+    pos++;
+  }
+}
+
+bool TextScanner::NextToken(std::string& token) {
+  SkipBlanks();
+  const char* begin = pos;
+  while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\r' && *pos != '\n') {
+    pos++;
+  }
+  token.assign(begin, pos);
+  return pos > begin;
+}
+
+bool TextScanner::NextInt(int& value) {
+  SkipBlanks();
+  const char* cursor = pos;
+  bool negative = cursor < end && *cursor == '-';
+  if (negative || (cursor < end && *cursor == '+')) {
+    cursor++;
+  }
+
+  const char* digits = cursor;
+  long long result = 0;
+  while (cursor < end && *cursor >= '0' && *cursor <= '9' && result <= INT32_MAX) {
+    result = result * 10 + (*cursor++ - '0');
+  }
+  if (cursor == digits || result > INT32_MAX ||
+      (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')) {
+    return false;
+  }
+
+  value = static_cast<int>(negative ? -result : result);
+  pos = cursor;
+  return true;
+}
+
+bool TextScanner::NextDouble(double& value) {
+  SkipBlanks();
+  const char* cursor = pos;
+  bool negative = cursor < end && *cursor == '-';
+  if (negative || (cursor < end && *cursor == '+')) {
+    cursor++;
+  }
+
+  // Collect up to 19 significant digits and the decimal exponent they imply
+  uint64_t mantissa = 0;
+  int significant = 0;
+  int exponent = 0;
+  bool any_digit = false;
+  for (; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, any_digit = true) {
+    if (significant < 19) {
+      mantissa = mantissa * 10 + (*cursor - '0');
+      significant += mantissa > 0;
+    } else {
+      exponent++;
+    }
+  }
+  if (cursor < end && *cursor == '.') {
+    for (cursor++; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, any_digit = true) {
+      if (significant < 19) {
+        mantissa = mantissa * 10 + (*cursor - '0');
+        significant += mantissa > 0;
+        exponent--;
+      }
+    }
+  }
+  if (!any_digit) {
+    return false;
+  }
+
+  if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+    const char* start = pos;
+    pos = cursor + 1;
+    int power;
+    if (!NextInt(power)) {
+      pos = start;
+      return false;
+    }
+    exponent += power;
+    cursor = pos;
+  } else if (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') {
+    return false;
+  }
+
+  double result = static_cast<double>(mantissa);
+  if (exponent < 0) {
+    result /= std::pow(10.0, -exponent);
+  } else if (exponent > 0) {
+    result *= std::pow(10.0, exponent);
+  }
+  value = negative ? -result : result;
+  pos = cursor;
+  return true;
+}
+
+bool TextScanner::NextLine(const char*& line, size_t& length) {
+  if (pos >= end) {
+    return false;
+  }
+
+  line = pos;
+  while (pos < end && *pos != '\n') {
+    pos++;
+  }
+  length = pos - line;
+  if (length > 0 && line[length - 1] == '\r') {
+    length--;
+  }
+  if (pos < end) {
+    pos++;
+  }
+  return true;
+}
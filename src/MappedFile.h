@@ -0,0 +1,136 @@
+/**
+ * @file MappedFile.h
+ * @brief Defines read-only memory-mapped files and a tokenizer for the MovingAI formats.
+ *
+ * Map and scenario files are parsed straight from the mapped bytes, without
+ * copying lines into strings or going through stream extraction, so setup
+ * stays cheap even for large maps and long scenario files.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Maps a whole file into memory for reading and unmaps it on destruction.
+ *
+ * Uses mmap on POSIX systems. On other platforms the file is read into a
+ * heap buffer instead, behind the same interface.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file.
+     *
+     * @param path Path to the file
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Checks if the file was opened and mapped.
+     */
+    bool IsOpen() const { return is_open; }
+
+    /**
+     * @brief Gets the first byte of the file (not null-terminated).
+     */
+    const char* Data() const { return data; }
+
+    /**
+     * @brief Gets the size of the file in bytes.
+     */
+    size_t Size() const { return size; }
+
+private:
+    const char* data = nullptr;  ///< Mapped bytes
+    size_t size = 0;             ///< Number of mapped bytes
+    bool is_open = false;        ///< Whether the file was opened
+    bool is_mapped = false;      ///< Whether data must be unmapped rather than deleted
+};
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a byte range.
+ *
+ * Used to tie preprocessed files to the exact source they were built from.
+ *
+ * @param data First byte
+ * @param size Number of bytes
+ * @return Hash of the bytes
+ */
+uint64_t HashBytes(const char* data, size_t size);
+
+/**
+ * @brief Reads whitespace-separated tokens and lines from a character range.
+ *
+ * Accepts both '\n' and "\r\n" line endings. Numbers are parsed by hand;
+ * a field that is not a number makes the read fail without moving on.
+ */
+class TextScanner {
+public:
+    /**
+     * @brief Constructs a scanner over [begin, end).
+     */
+    TextScanner(const char* begin, const char* end) : pos(begin), end(end) {}
+
+    /**
+     * @brief Checks if all input was consumed.
+     */
+    bool AtEnd() const { return pos >= end; }
+
+    /**
+     * @brief Reads the next token on the current line.
+     *
+     * @param token Output: the token's characters
+     * @return false if the line has no more tokens
+     */
+    bool NextToken(std::string& token);
+
+    /**
+     * @brief Reads the next token on the current line as an integer.
+     *
+     * @param value Output value
+     * @return false if there is no token or it is not an integer
+     */
+    bool NextInt(int& value);
+
+    /**
+     * @brief Reads the next token on the current line as a decimal number.
+     *
+     * @param value Output value
+     * @return false if there is no token or it is not a number
+     */
+    bool NextDouble(double& value);
+
+    /**
+     * @brief Reads the rest of the current line and moves to the next one.
+     *
+     * @param line Output: start of the line's characters
+     * @param length Output: number of characters, without the line ending
+     * @return false if the input is exhausted
+     */
+    bool NextLine(const char*& line, size_t& length);
+
+    /**
+     * @brief Skips the rest of the current line.
+     */
+    void SkipLine();
+
+private:
+    const char* pos;  ///< Next unread character
+    const char* end;  ///< One past the last character
+
+    /**
+     * @brief Skips spaces and tabs, stopping at the end of the line.
+     */
+    void SkipBlanks();
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,325 @@
+#include "Microbenchmark.h"
+#include "AStar.h"
+#include "ReservationTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Heap allocations since the start of the program
+std::atomic<long long> allocation_count{0};
+
+// Kernels add their results here, so the compiler cannot drop the calls
+volatile size_t sink = 0;
+
+// Exposes the conflict detection that the solvers run internally
+struct ConflictProbe : CBS {
+  using CBS::CBS;
+  using Solver::FindConflict;
+  using Solver::CalculateSolutionCost;
+};
+
+}  // namespace
+
+// Counting replacements of the global allocation functions
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+Microbenchmark::Microbenchmark(std::shared_ptr<Map> _map, const std::vector<AgentData>& entries)
+  : map(std::move(_map)) {
+  AStar astar(map);
+  for (const AgentData& entry : entries) {
+    if (!map->IsInBounds(entry.start_row, entry.start_col) || !map->IsInBounds(entry.dest_row, entry.dest_col)) {
+      continue;
+    }
+    auto path = astar.FindPath(entry.start_row, entry.start_col, entry.dest_row, entry.dest_col,
+                               static_cast<int>(agents.size()), 0);
+    if (path.size() < 2) {
+      continue;  // Blocked, unreachable, or already at the goal
+    }
+    agents.push_back(std::make_shared<Agent>(static_cast<int>(agents.size()), entry.start_row, entry.start_col,
+                                             entry.dest_row, entry.dest_col, entry.optimal_distance, map));
+    shortest_paths.push_back(std::move(path));
+  }
+  if (agents.empty()) {
+    throw std::runtime_error("No scenario entry has a path on map " + map->GetName());
+  }
+
+  for (int row = 0; row < map->GetHeight(); row++) {
+    for (int col = 0; col < map->GetWidth(); col++) {
+      if (map->IsPassable(map->GetIndex(row, col))) {
+        passable_cells.emplace_back(row, col);
+      }
+    }
+  }
+
+  // Paths planned one after another around the earlier ones never conflict;
+  // agents that cannot get around them are left out
+  ReservationTable reservations;
+  for (int agent = 0; agent < static_cast<int>(agents.size()); agent++) {
+    if (static_cast<int>(planned_agents.size()) == MAX_GROUP_SIZE) {
+      break;
+    }
+    const AgentData& data = agents[agent]->GetAgentData();
+    auto path = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col, agent, 0, reservations);
+    if (!path.empty() && path.back()->row == data.dest_row && path.back()->col == data.dest_col) {
+      reservations.ReservePath(path, agent);
+      planned_agents.push_back(agents[agent]);
+      planned_paths.push_back(std::move(path));
+    }
+  }
+}
+
+void Microbenchmark::SetMinTime(double seconds) {
+  min_time = seconds;
+}
+
+KernelResult Microbenchmark::Measure(const std::string& name, const std::function<void(long long)>& kernel,
+                                     long long cycle) const {
+  // One call outside the measurement fills caches such as the distance tables
+  kernel(0);
+
+  // Double the calls until a round takes the minimum time
+  long long iterations = cycle;
+  long long allocations = 0;
+  double elapsed = 0;
+  auto round = [&]() {
+    long long allocations_before = allocation_count.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; i++) {
+      kernel(i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+    return seconds;
+  };
+  while ((elapsed = round()) < min_time) {
+    iterations *= 2;
+  }
+
+  // The fastest round is the one least disturbed by other processes
+  for (int repetition = 1; repetition < REPETITIONS; repetition++) {
+    elapsed = std::min(elapsed, round());
+  }
+
+  KernelResult result;
+  result.name = name;
+  result.iterations = iterations;
+  result.ns_per_op = elapsed * 1e9 / iterations;
+  result.allocs_per_op = static_cast<double>(allocations) / iterations;
+  return result;
+}
+
+Constraints Microbenchmark::MakeConstraints(int agent, int count) const {
+  const auto& path = shortest_paths[agent];
+  int steps = static_cast<int>(path.size()) - 1;
+  Constraints constraints;
+  for (int i = 0; i < count; i++) {
+    int step = 1 + i % steps;
+    constraints.addVertexConstraint(VertexConstraint{agent, path[step]->row, path[step]->col, step + i / steps});
+  }
+  return constraints;
+}
+
+std::vector<KernelResult> Microbenchmark::Run(const std::string& filter) {
+  std::vector<KernelResult> results;
+  auto run = [&](const std::string& name, const std::function<void(long long)>& kernel, long long cycle) {
+    if (name.find(filter) != std::string::npos) {
+      results.push_back(Measure(name, kernel, cycle));
+    }
+  };
+
+  // Low-level search, one agent per call in turn
+  int agent_count = static_cast<int>(agents.size());
+  int search_count = std::min(agent_count, SEARCH_AGENTS);
+  AStar astar(map);
+  for (int constraint_count : {0, 10, 100}) {
+    std::vector<Constraints> constraints;
+    for (int agent = 0; agent < search_count; agent++) {
+      constraints.push_back(MakeConstraints(agent, constraint_count));
+    }
+    run("astar/constraints-" + std::to_string(constraint_count), [&](long long i) {
+      int agent = static_cast<int>(i % search_count);
+      const AgentData& data = agents[agent]->GetAgentData();
+      sink = sink + astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col, agent, 0,
+                                   constraints[agent]).size();
+    }, search_count);
+  }
+
+  run("map/neighbors", [&](long long i) {
+    const auto& cell = passable_cells[i % passable_cells.size()];
+    sink = sink + map->GetNeighbors(cell.first, cell.second).size();
+  }, passable_cells.size());
+
+  // A constraint tree node deep in the search: constraints on several agents, lookups half hits and half misses
+  Constraints node_constraints;
+  for (int agent = 0; agent < std::min(agent_count, 10); agent++) {
+    node_constraints.merge(MakeConstraints(agent, 10));
+  }
+  std::vector<VertexConstraint> lookups;
+  for (const VertexConstraint& constraint : node_constraints.vertex_constraints) {
+    lookups.push_back(constraint);
+    lookups.push_back(VertexConstraint{constraint.agent_id, constraint.row, constraint.col, constraint.time + 1000});
+  }
+  run("constraints/vertex-lookup", [&](long long i) {
+    const VertexConstraint& query = lookups[i % lookups.size()];
+    sink = sink + node_constraints.hasVertexConstraint(query.agent_id, query.row, query.col, query.time);
+  }, lookups.size());
+
+  // Conflict detection and node copies, as CBS runs them per expanded node
+  int planned_count = static_cast<int>(planned_agents.size());
+  std::vector<int> group_sizes;
+  for (int size : {10, 50, MAX_GROUP_SIZE}) {
+    int capped = std::min(size, planned_count);
+    if (capped > 0 && (group_sizes.empty() || group_sizes.back() != capped)) {
+      group_sizes.push_back(capped);
+    }
+  }
+  for (int size : group_sizes) {
+    std::vector<std::shared_ptr<Agent>> group(planned_agents.begin(), planned_agents.begin() + size);
+    ConflictProbe probe(map, group);
+    CBSNode node;
+    node.constraints = node_constraints;
+    node.solution.assign(planned_paths.begin(), planned_paths.begin() + size);
+    node.cost = probe.CalculateSolutionCost(node.solution);
+
+    std::string find_name = "cbs/find-conflict/agents-" + std::to_string(size);
+    std::string copy_name = "cbs/node-copy/agents-" + std::to_string(size);
+    run(find_name, [&](long long) {
+      sink = sink + (probe.FindConflict(node.solution) != nullptr);
+    }, 1);
+    run(copy_name, [&](long long) {
+      CBSNode copy = node;
+      sink = sink + copy.solution.size();
+    }, 1);
+  }
+  return results;
+}
+
+bool Microbenchmark::WriteBaseline(const std::string& path, const std::vector<KernelResult>& results) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Error: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  file << "kernel,iterations,ns_per_op,allocs_per_op\n" << std::setprecision(10);
+  for (const KernelResult& result : results) {
+    file << result.name << ',' << result.iterations << ',' << result.ns_per_op << ',' << result.allocs_per_op << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+std::vector<KernelResult> Microbenchmark::ReadBaseline(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open baseline file: " + path);
+  }
+
+  std::vector<KernelResult> baseline;
+  std::string line;
+  std::getline(file, line);  // Header
+  int line_number = 1;
+  while (std::getline(file, line)) {
+    line_number++;
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    KernelResult result;
+    std::string iterations, ns_per_op, allocs_per_op;
+    if (!std::getline(fields, result.name, ',') || !std::getline(fields, iterations, ',') ||
+        !std::getline(fields, ns_per_op, ',') || !std::getline(fields, allocs_per_op)) {
+      throw std::runtime_error("Malformed baseline line " + std::to_string(line_number) + " in " + path);
+    }
+    try {
+      result.iterations = std::stoll(iterations);
+      result.ns_per_op = std::stod(ns_per_op);
+      result.allocs_per_op = std::stod(allocs_per_op);
+    } catch (const std::exception&) {
+      throw std::runtime_error("Malformed baseline line " + std::to_string(line_number) + " in " + path);
+    }
+    baseline.push_back(result);
+  }
+  return baseline;
+}
+
+void Microbenchmark::Print(const std::vector<KernelResult>& results) {
+  std::cout << std::left << std::setw(32) << "kernel" << std::right << std::setw(14) << "ns/op"
+            << std::setw(14) << "allocs/op" << std::setw(12) << "calls" << "\n";
+  for (const KernelResult& result : results) {
+    std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(14) << result.ns_per_op
+              << std::setprecision(2) << std::setw(14) << result.allocs_per_op
+              << std::setw(12) << result.iterations << "\n";
+  }
+  std::cout << std::defaultfloat << std::flush;
+}
+
+int Microbenchmark::Compare(const std::vector<KernelResult>& results, const std::vector<KernelResult>& baseline,
+                            double tolerance) {
+  int regressions = 0;
+  std::cout << std::left << std::setw(32) << "kernel" << std::right << std::setw(14) << "base ns/op"
+            << std::setw(14) << "ns/op" << std::setw(10) << "change" << std::setw(14) << "base allocs"
+            << std::setw(10) << "allocs" << "\n";
+  for (const KernelResult& result : results) {
+    auto base = std::find_if(baseline.begin(), baseline.end(),
+                             [&](const KernelResult& entry) { return entry.name == result.name; });
+    std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(1);
+    if (base == baseline.end()) {
+      std::cout << std::setw(14) << "-" << std::setw(14) << result.ns_per_op << std::setw(10) << "new"
+                << std::setw(14) << "-" << std::setprecision(2) << std::setw(10) << result.allocs_per_op << "\n";
+      continue;
+    }
+
+    // Allocation counts are deterministic, so only rounding is allowed for them
+    double change = base->ns_per_op > 0 ? result.ns_per_op / base->ns_per_op - 1.0 : 0.0;
+    bool slower = change > tolerance;
+    bool allocates_more = result.allocs_per_op > base->allocs_per_op + 0.01;
+    std::ostringstream percent;
+    percent << std::showpos << std::fixed << std::setprecision(1) << change * 100 << '%';
+    std::cout << std::setw(14) << base->ns_per_op << std::setw(14) << result.ns_per_op << std::setw(10)
+              << percent.str() << std::setprecision(2) << std::setw(14) << base->allocs_per_op << std::setw(10)
+              << result.allocs_per_op;
+    if (slower || allocates_more) {
+      std::cout << "  REGRESSION";
+      regressions++;
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::defaultfloat << std::flush;
+  return regressions;
+}
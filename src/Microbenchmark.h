@@ -0,0 +1,155 @@
+/**
+ * @file Microbenchmark.h
+ * @brief Defines the microbenchmarks of the hot kernels of the solvers.
+ *
+ * Each kernel runs on its own, on inputs built from one map and one
+ * scenario, so a change to a kernel shows up without the noise of a whole
+ * search. A kernel is repeated until it has run for a minimum time and is
+ * reported as time and heap allocations per call. Results can be stored as
+ * a baseline and later runs compared against it.
+ *
+ * The allocation counts come from a replaced global operator new that is
+ * part of this module, so it is only linked into the benchmark executable.
+ */
+
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include "Map.h"
+#include "Agent.h"
+#include "CBS.h"
+
+/**
+ * @brief Measurement of one kernel.
+ */
+struct KernelResult {
+    std::string name;        ///< Kernel name, e.g. "astar/constraints-10"
+    long long iterations;    ///< Calls measured
+    double ns_per_op;        ///< Wall-clock nanoseconds per call
+    double allocs_per_op;    ///< Heap allocations per call
+};
+
+/**
+ * @brief Runs the kernel benchmarks on one map and scenario.
+ */
+class Microbenchmark {
+public:
+    /// Largest number of agents whose paths conflict detection and node copies are timed on
+    static constexpr int MAX_GROUP_SIZE = 100;
+
+    /// Agents the low-level search kernels take turns with
+    static constexpr int SEARCH_AGENTS = 8;
+
+    /// Timed rounds per kernel; the fastest one is reported
+    static constexpr int REPETITIONS = 3;
+
+    /**
+     * @brief Prepares the inputs of all kernels.
+     *
+     * Scenario entries that are outside the map, blocked or unreachable are
+     * skipped, so any scenario of the map's size can be used.
+     *
+     * @param _map Shared pointer to the loaded map
+     * @param entries Start and goal of every agent of the scenario
+     * @throw std::runtime_error if no entry has a path
+     */
+    Microbenchmark(std::shared_ptr<Map> _map, const std::vector<AgentData>& entries);
+
+    /**
+     * @brief Sets how long each kernel is repeated.
+     *
+     * @param seconds Minimum measured time per kernel
+     */
+    void SetMinTime(double seconds);
+
+    /**
+     * @brief Runs the kernels whose name contains a filter.
+     *
+     * @param filter Part of the kernel names to run, empty for all
+     * @return One result per kernel run
+     */
+    std::vector<KernelResult> Run(const std::string& filter = "");
+
+    /**
+     * @brief Writes results as a baseline CSV file.
+     *
+     * @param path Output file
+     * @param results Results to store
+     * @return false (after printing an error) if the file cannot be written
+     */
+    static bool WriteBaseline(const std::string& path, const std::vector<KernelResult>& results);
+
+    /**
+     * @brief Reads a baseline written by WriteBaseline().
+     *
+     * @param path Baseline file
+     * @return The stored results
+     * @throw std::runtime_error if the file cannot be read or parsed
+     */
+    static std::vector<KernelResult> ReadBaseline(const std::string& path);
+
+    /**
+     * @brief Prints results next to a baseline and flags regressions.
+     *
+     * A kernel regresses if it is slower than the baseline by more than the
+     * tolerance, or allocates more per call. Kernels missing from the
+     * baseline are listed but never regress.
+     *
+     * @param results Current results
+     * @param baseline Stored results
+     * @param tolerance Allowed slowdown as a fraction, e.g. 0.1 for 10%
+     * @return Number of regressed kernels
+     */
+    static int Compare(const std::vector<KernelResult>& results, const std::vector<KernelResult>& baseline,
+                       double tolerance);
+
+    /**
+     * @brief Prints results as a table.
+     *
+     * @param results Results to print
+     */
+    static void Print(const std::vector<KernelResult>& results);
+
+private:
+    std::shared_ptr<Map> map;                        ///< Map all kernels run on
+    std::vector<std::shared_ptr<Agent>> agents;      ///< Usable scenario agents, IDs in scenario order
+    std::vector<std::vector<std::shared_ptr<Cell>>> shortest_paths;  ///< Unconstrained path of each agent
+    std::vector<std::pair<int, int>> passable_cells; ///< Passable cells in row-major order
+    std::vector<std::shared_ptr<Agent>> planned_agents;  ///< Agents with a conflict-free path, at most MAX_GROUP_SIZE
+    std::vector<std::vector<std::shared_ptr<Cell>>> planned_paths;  ///< Conflict-free paths of the planned agents
+    double min_time = 0.5;                           ///< Seconds each kernel runs at least
+
+    /**
+     * @brief Repeats a kernel until it has run for the minimum time.
+     *
+     * The call count doubles until one round takes the minimum time, so the
+     * clock is read rarely; then more rounds of that size run.
+     *
+     * @param name Kernel name
+     * @param kernel One call of the kernel; the argument counts the calls
+     * @param cycle Calls after which the kernel repeats its inputs; rounds
+     *              are whole cycles, so allocation counts do not depend on the round size
+     * @return Time and allocations per call
+     */
+    KernelResult Measure(const std::string& name, const std::function<void(long long)>& kernel,
+                         long long cycle) const;
+
+    /**
+     * @brief Builds vertex constraints on the shortest path of an agent.
+     *
+     * The constraints block the path cells at the times the agent would
+     * pass them, as CBS adds them, and then the same cells one step later
+     * and so on once the path is used up. The start is never blocked.
+     *
+     * @param agent Index of the agent
+     * @param count Number of constraints
+     * @return The constraints
+     */
+    Constraints MakeConstraints(int agent, int count) const;
+};
+
+#endif // MICROBENCHMARK_H
@@ -0,0 +1,65 @@
+#include "OccupancyTable.h"
+#include <algorithm>
+
+OccupancyTable::OccupancyTable(const Map& map, const std::vector<std::vector<std::shared_ptr<Cell>>>& solution)
+  : map_width(map.GetWidth()),
+    cell_count(map.GetCellCount()),
+    cell_offsets(cell_count + 1, 0),
+    goal_agents(cell_count, -1),
+    goal_times(cell_count, 0) {
+  // Count the visits of each cell, then lay the runs out back to back
+  for (const auto& path : solution) {
+    for (const auto& cell : path) {
+      cell_offsets[cell->row * map_width + cell->col + 1]++;
+    }
+    time_steps = std::max(time_steps, static_cast<int>(path.size()));
+  }
+  for (int i = 0; i < cell_count; i++) {
+    cell_offsets[i + 1] += cell_offsets[i];
+  }
+
+  entries.resize(cell_offsets[cell_count]);
+  std::vector<int> next(cell_offsets.begin(), cell_offsets.end() - 1);
+  for (size_t agent = 0; agent < solution.size(); agent++) {
+    const auto& path = solution[agent];
+    for (size_t t = 0; t < path.size(); t++) {
+      entries[next[path[t]->row * map_width + path[t]->col]++] = {static_cast<int>(t), static_cast<int>(agent)};
+    }
+    if (path.empty()) {
+      continue;
+    }
+
+    // The agent stays at its goal once the path ends
+    int goal = path.back()->row * map_width + path.back()->col;
+    if (goal_agents[goal] == -1) {
+      goal_agents[goal] = agent;
+      goal_times[goal] = path.size() - 1;
+    }
+  }
+
+  // Agents were added in ID order, so a stable sort keeps the lower ID first at equal times
+  for (int i = 0; i < cell_count; i++) {
+    if (cell_offsets[i + 1] - cell_offsets[i] > 1) {
+      std::stable_sort(entries.begin() + cell_offsets[i], entries.begin() + cell_offsets[i + 1],
+                       [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    }
+  }
+}
+
+int OccupancyTable::GetAgentAt(int index, int time) const {
+  if (index < 0 || index >= cell_count || time < 0) {
+    return -1;
+  }
+
+  auto begin = entries.begin() + cell_offsets[index];
+  auto end = entries.begin() + cell_offsets[index + 1];
+  auto it = std::lower_bound(begin, end, time, [](const Entry& entry, int t) { return entry.time < t; });
+  if (it != end && it->time == time) {
+    return it->agent;
+  }
+
+  if (goal_agents[index] != -1 && time >= goal_times[index]) {
+    return goal_agents[index];
+  }
+  return -1;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file OccupancyTable.h
+ * @brief Defines the space-time table of a published solution.
+ *
+ * Searches never write to the map. Once a solver has a final solution, it
+ * records every path in this table and hands it to the map, which answers
+ * IsOccupied() and GetAgentAt() from it. Unlike ReservationTable, which
+ * prioritized engines fill and clear many times per search, this table is
+ * built once per solution from all paths at once.
+ */
+
+#ifndef OCCUPANCY_TABLE_H
+#define OCCUPANCY_TABLE_H
+
+#include <vector>
+#include <memory>
+#include "Map.h"
+
+/**
+ * @brief Stores which agent occupies each cell at each time step.
+ *
+ * Only occupied entries are stored: every cell has a run of (time, agent)
+ * pairs sorted by time in one shared array, so memory grows with the sum
+ * of the path lengths rather than with makespan x map size. An agent
+ * stays at its goal once its path ends; that is stored once per goal cell
+ * instead of in every later time step.
+ */
+class OccupancyTable {
+public:
+    /**
+     * @brief Records the paths of a solution.
+     *
+     * If two agents occupy the same cell at the same time, the one with
+     * the lower ID keeps it.
+     *
+     * @param map Map whose cells are indexed
+     * @param solution Path of each agent, indexed by agent ID and time step
+     */
+    OccupancyTable(const Map& map, const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+
+    /**
+     * @brief Gets the agent occupying a cell at a time step.
+     *
+     * @param index Flat cell index
+     * @param time Time step
+     * @return Agent ID if occupied, -1 otherwise
+     */
+    int GetAgentAt(int index, int time) const;
+
+    /**
+     * @brief Gets the length of the longest path.
+     *
+     * After the last time step only agents waiting at their goals occupy cells.
+     */
+    int GetTimeSteps() const { return time_steps; }
+
+private:
+    /**
+     * @brief Visit of a cell by an agent.
+     */
+    struct Entry {
+        int time;   ///< Time step of the visit
+        int agent;  ///< Agent in the cell
+    };
+
+    int map_width;                  ///< Row stride of the flat cell index
+    int cell_count;                 ///< Number of cells
+    int time_steps = 0;             ///< Length of the longest path
+    std::vector<int> cell_offsets;  ///< Cell -> first entry of its run, with one extra end offset
+    std::vector<Entry> entries;     ///< Runs of visits, one per cell, sorted by time
+    std::vector<int> goal_agents;   ///< Cell -> agent waiting there, -1 if none
+    std::vector<int> goal_times;    ///< Cell -> time step from which the agent waits there
+};
+
+#endif // OCCUPANCY_TABLE_H
@@ -0,0 +1,197 @@
+#include "PBS.h"
+#include <stack>
+
+PBS::PBS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents) : Solver(_map, _agents) {}
+
+bool PBS::PathFind() {
+  BeginPathFind();
+
+  // Create root node without any priorities
+  PBSNode root;
+  root.higher.resize(agents.size());
+  root.lower.resize(agents.size());
+  root.solution.resize(agents.size());
+
+  AStar astar(map);
+  astar.SetDeadline(deadline);
+  for (size_t i = 0; i < agents.size(); i++) {
+    root.solution[i] = PlanAgent(root, i, astar);
+    if (root.solution[i].empty()) {
+      if (DeadlinePassed()) {
+        if (verbose) {
+          std::cerr << "PBS reached its deadline while planning the root paths" << std::endl;
+        }
+        return false;
+      }
+      if (verbose) {
+        std::cerr << "No solution exists for at least one agent" << std::endl;
+      }
+      return false;
+    }
+  }
+
+  root.cost = CalculateSolutionCost(root.solution);
+  root.conflict = FindConflict(root.solution);
+
+  // Depth-first search over priority orderings
+  std::stack<PBSNode> open_list;
+  open_list.push(std::move(root));
+  MAPF_STATS(stats.high_level_generated++);
+
+  int max_iterations = 1000;
+  int iteration_count = 0;
+
+  while (!open_list.empty()) {
+    if (iteration_count >= max_iterations) {
+      if (verbose) {
+        std::cerr << "No solution found within " << max_iterations << " iterations" << std::endl;
+      }
+      return false;
+    }
+    if (DeadlinePassed()) {
+      if (verbose) {
+        std::cerr << "PBS reached its deadline after " << iteration_count << " iterations" << std::endl;
+      }
+      return false;
+    }
+
+    PBSNode current = std::move(open_list.top());
+    open_list.pop();
+    stats.high_level_expanded++;
+
+    if (!current.conflict) {
+      // Publish the final solution to the map and the agents
+      ApplySolution(current.solution);
+
+      if (verbose) {
+        std::cout << "Solution found with cost: " << current.cost << std::endl;
+      }
+      return true;
+    }
+
+    // Branch on which of the two agents gets priority
+    std::vector<PBSNode> children;
+    int agent1 = current.conflict->agent1_id;
+    int agent2 = current.conflict->agent2_id;
+    for (const auto& [high, low] : {std::make_pair(agent1, agent2), std::make_pair(agent2, agent1)}) {
+      // Skip orderings that would make the priorities cyclic
+      if (Reachable(current.higher, high).count(low) > 0) {
+        continue;
+      }
+
+      PBSNode child = current;
+      child.higher[low].insert(high);
+      child.lower[high].insert(low);
+
+      if (UpdatePlan(child, low, astar)) {
+        child.cost = CalculateSolutionCost(child.solution);
+        child.conflict = FindConflict(child.solution);
+        children.push_back(std::move(child));
+        MAPF_STATS(stats.high_level_generated++);
+      }
+    }
+
+    // Push the cheaper child last so it is expanded first
+    std::sort(children.begin(), children.end(), [](const PBSNode& a, const PBSNode& b) {
+      return a.cost > b.cost;
+    });
+    for (auto& child : children) {
+      open_list.push(std::move(child));
+    }
+
+    iteration_count++;
+  }
+
+  if (verbose) {
+    std::cerr << "No solution found for all agents after exploring all priority orderings" << std::endl;
+  }
+  return false;
+}
+
+std::unordered_set<int> PBS::Reachable(const std::vector<std::unordered_set<int>>& edges, int agent_id) const {
+  std::unordered_set<int> visited;
+  std::vector<int> frontier = {agent_id};
+
+  while (!frontier.empty()) {
+    int current = frontier.back();
+    frontier.pop_back();
+    for (int next : edges[current]) {
+      if (visited.insert(next).second) {
+        frontier.push_back(next);
+      }
+    }
+  }
+
+  return visited;
+}
+
+bool PBS::UpdatePlan(PBSNode& node, int agent_id, AStar& astar) {
+  // Agents that may have to move: the changed agent and everything below it
+  std::unordered_set<int> affected = Reachable(node.lower, agent_id);
+  affected.insert(agent_id);
+
+  // Topologically sort the affected agents (higher priority first)
+  std::unordered_map<int, int> in_degree;
+  for (int a : affected) {
+    in_degree[a] = 0;
+    for (int h : node.higher[a]) {
+      if (affected.count(h) > 0) {
+        in_degree[a]++;
+      }
+    }
+  }
+
+  std::vector<int> ready;
+  for (const auto& [a, degree] : in_degree) {
+    if (degree == 0) {
+      ready.push_back(a);
+    }
+  }
+
+  while (!ready.empty()) {
+    int current = ready.back();
+    ready.pop_back();
+
+    // Replan if this is the changed agent or it collides with someone above it
+    bool needs_replan = current == agent_id;
+    if (!needs_replan) {
+      for (int h : Reachable(node.higher, current)) {
+        int conflict_time = 0;
+        auto conflict = std::make_shared<Conflict>();
+        if (HasConflict(node.solution[h], node.solution[current], conflict_time, conflict)) {
+          needs_replan = true;
+          break;
+        }
+      }
+    }
+
+    if (needs_replan) {
+      node.solution[current] = PlanAgent(node, current, astar);
+      if (node.solution[current].empty()) {
+        return false;
+      }
+    }
+
+    for (int l : node.lower[current]) {
+      if (affected.count(l) > 0 && --in_degree[l] == 0) {
+        ready.push_back(l);
+      }
+    }
+  }
+
+  return true;
+}
+
+std::vector<std::shared_ptr<Cell>> PBS::PlanAgent(const PBSNode& node, int agent_id, AStar& astar) {
+  // Reserve the paths of every agent with higher priority
+  ReservationTable reservations;
+  for (int h : Reachable(node.higher, agent_id)) {
+    reservations.ReservePath(node.solution[h], h);
+  }
+
+  const AgentData& data = agents[agent_id]->GetAgentData();
+  auto path = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col,
+                             agent_id, 0, reservations);
+  stats.AddSearch(astar.GetLastStats());
+  return path;
+}
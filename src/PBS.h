@@ -0,0 +1,91 @@
+/**
+ * @file PBS.h
+ * @brief Defines the Priority-Based Search (PBS) engine.
+ *
+ * PBS searches over partial priority orderings instead of constraint sets.
+ * Each conflict is resolved by letting one of the two agents take priority
+ * over the other; lower-priority agents then replan around the reserved
+ * paths of all agents above them.
+ */
+
+#ifndef PBS_H
+#define PBS_H
+
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include "Map.h"
+#include "Agent.h"
+#include "AStar.h"
+#include "Solver.h"
+#include "ReservationTable.h"
+
+/**
+ * @brief Represents a node in the PBS priority tree.
+ *
+ * Each node holds a partial priority ordering, a solution consistent with
+ * it, and the first conflict left in that solution.
+ */
+struct PBSNode {
+    std::vector<std::unordered_set<int>> higher;  ///< higher[j]: agents directly above j
+    std::vector<std::unordered_set<int>> lower;   ///< lower[i]: agents directly below i
+    std::vector<std::vector<std::shared_ptr<Cell>>> solution;  ///< Paths for all agents
+    int cost;  ///< Sum of path costs
+    std::shared_ptr<Conflict> conflict;  ///< First conflict found in solution
+};
+
+/**
+ * @brief Implements Priority-Based Search.
+ *
+ * The priority tree is explored depth-first; of the two children of a node
+ * the cheaper one is expanded first.
+ */
+class PBS : public Solver {
+public:
+    /**
+     * @brief Constructs a new PBS solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    PBS(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Finds conflict-free paths for all agents.
+     *
+     * @return true if a conflict-free solution was found
+     */
+    bool PathFind() override;
+
+private:
+    /**
+     * @brief Collects all agents transitively above or below an agent.
+     *
+     * @param edges Either PBSNode::higher or PBSNode::lower
+     * @param agent_id Agent to start from
+     * @return Set of reachable agents, excluding agent_id itself
+     */
+    std::unordered_set<int> Reachable(const std::vector<std::unordered_set<int>>& edges, int agent_id) const;
+
+    /**
+     * @brief Replans an agent and every lower agent that collides with it.
+     *
+     * @param node Node to update in place
+     * @param agent_id Agent whose priority changed
+     * @param astar Low-level planner
+     * @return false if some agent has no path under the priorities
+     */
+    bool UpdatePlan(PBSNode& node, int agent_id, AStar& astar);
+
+    /**
+     * @brief Plans one agent around all agents above it.
+     *
+     * @param node Node holding the priorities and current paths
+     * @param agent_id Agent to plan
+     * @param astar Low-level planner
+     * @return Vector of cells representing the path, empty if none exists
+     */
+    std::vector<std::shared_ptr<Cell>> PlanAgent(const PBSNode& node, int agent_id, AStar& astar);
+};
+
+#endif // PBS_H
@@ -0,0 +1,220 @@
+#include "PIBT.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <unordered_map>
+
+PIBT::PIBT(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents)
+  : Solver(_map, _agents), max_timesteps(1000), rng(0), fixed_move_broken(false) {}
+
+void PIBT::SetMaxTimesteps(int timesteps) { max_timesteps = timesteps; }
+void PIBT::SetSeed(unsigned int seed) { rng.seed(seed); }
+
+bool PIBT::Initialize() {
+  starts.resize(agents.size());
+  goals.resize(agents.size());
+  distance_tables.resize(agents.size());
+  std::unordered_map<int, std::shared_ptr<DistanceTable>> tables_by_goal;
+
+  for (size_t i = 0; i < agents.size(); i++) {
+    const AgentData& data = agents[i]->GetAgentData();
+    if (!map->IsInBounds(data.start_row, data.start_col) || !map->IsInBounds(data.dest_row, data.dest_col)) {
+      return false;
+    }
+    starts[i] = map->GetIndex(data.start_row, data.start_col);
+    goals[i] = map->GetIndex(data.dest_row, data.dest_col);
+    auto& table = tables_by_goal[goals[i]];
+    if (!table) {
+      table = std::make_shared<DistanceTable>(map, goals[i], starts[i]);
+    }
+    distance_tables[i] = table;
+    if (GetDistance(i, starts[i]) == Map::UNREACHABLE) {
+      return false;
+    }
+  }
+
+  occupied_now.assign(map->GetCellCount(), -1);
+  occupied_next.assign(map->GetCellCount(), -1);
+  return true;
+}
+
+bool PIBT::PathFind() {
+  BeginPathFind();
+  if (!Initialize()) {
+    if (verbose) {
+      std::cerr << "No solution exists for at least one agent" << std::endl;
+    }
+    return false;
+  }
+
+  // Priority grows while an agent is away from its goal; the fraction breaks ties
+  std::uniform_real_distribution<float> tie(0.0f, 1.0f);
+  std::vector<float> priorities(agents.size());
+  for (auto& priority : priorities) {
+    priority = tie(rng);
+  }
+
+  std::vector<int> order(agents.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  std::vector<std::vector<int>> configurations = {starts};
+  bool all_at_goal = configurations.back() == goals;
+
+  for (int t = 0; t < max_timesteps && !all_at_goal; t++) {
+    if (DeadlinePassed()) {
+      if (verbose) {
+        std::cerr << "PIBT reached its deadline after " << t << " time steps" << std::endl;
+      }
+      return false;
+    }
+
+    std::sort(order.begin(), order.end(), [&priorities](int a, int b) {
+      return priorities[a] > priorities[b];
+    });
+
+    std::vector<int> next(agents.size(), -1);
+    Step(configurations.back(), next, order);
+
+    all_at_goal = true;
+    for (size_t i = 0; i < agents.size(); i++) {
+      if (next[i] == goals[i]) {
+        priorities[i] -= std::floor(priorities[i]);
+      } else {
+        priorities[i] += 1.0f;
+        all_at_goal = false;
+      }
+    }
+    configurations.push_back(std::move(next));
+  }
+
+  if (!all_at_goal) {
+    if (verbose) {
+      std::cerr << "PIBT did not reach all goals within " << max_timesteps << " time steps" << std::endl;
+    }
+    return false;
+  }
+
+  auto solution = ToSolution(configurations);
+
+  // Publish the final solution to the map and the agents
+  ApplySolution(solution);
+
+  if (verbose) {
+    std::cout << "Solution found with cost: " << CalculateSolutionCost(solution) << std::endl;
+  }
+  return true;
+}
+
+bool PIBT::Step(const std::vector<int>& current, std::vector<int>& next, const std::vector<int>& order) {
+  fixed_move_broken = false;
+  bool valid = true;
+
+  for (size_t i = 0; i < current.size(); i++) {
+    occupied_now[current[i]] = i;
+  }
+
+  // Register the fixed moves first
+  for (size_t i = 0; i < next.size(); i++) {
+    if (next[i] == -1) continue;
+    int other = occupied_now[next[i]];
+    if (occupied_next[next[i]] != -1 ||
+        (other != -1 && other != static_cast<int>(i) && next[other] == current[i])) {
+      valid = false;  // Two fixed moves collide or swap
+    }
+    occupied_next[next[i]] = i;
+    touched.push_back(next[i]);
+  }
+
+  if (valid) {
+    for (int agent_id : order) {
+      if (next[agent_id] == -1) {
+        Push(agent_id, -1, current, next);
+      }
+    }
+    valid = !fixed_move_broken;
+  }
+
+  // Reset the occupancy arrays for the next call
+  for (int index : current) {
+    occupied_now[index] = -1;
+  }
+  for (int index : touched) {
+    occupied_next[index] = -1;
+  }
+  touched.clear();
+
+  return valid;
+}
+
+bool PIBT::Push(int agent_id, int parent_id, const std::vector<int>& current, std::vector<int>& next) {
+  int from = current[agent_id];
+
+  // Candidates: all neighbors and staying, closest to the goal first
+  int candidates[9];
+  unsigned int tie_breakers[9];
+  int count = map->GetNeighborIds(from, candidates);
+  candidates[count++] = from;
+  for (int k = 0; k < count; k++) {
+    tie_breakers[k] = rng();
+  }
+
+  int ranks[9];
+  std::iota(ranks, ranks + count, 0);
+  std::sort(ranks, ranks + count, [&](int a, int b) {
+    int da = GetDistance(agent_id, candidates[a]);
+    int db = GetDistance(agent_id, candidates[b]);
+    if (da != db) return da < db;
+    return tie_breakers[a] < tie_breakers[b];
+  });
+
+  for (int k = 0; k < count; k++) {
+    int target = candidates[ranks[k]];
+    if (occupied_next[target] != -1) continue;
+
+    // Never swap with the agent that pushed us, nor with a fixed move
+    int occupant = occupied_now[target];
+    if (parent_id != -1 && target == current[parent_id]) continue;
+    if (occupant != -1 && next[occupant] == from) continue;
+
+    occupied_next[target] = agent_id;
+    touched.push_back(target);
+    next[agent_id] = target;
+
+    // Priority inheritance: the occupant must make room
+    if (occupant != -1 && occupant != agent_id && next[occupant] == -1 &&
+        !Push(occupant, agent_id, current, next)) {
+      continue;
+    }
+    return true;
+  }
+
+  // No cell is available: stay and let the parent try elsewhere
+  int claimant = occupied_next[from];
+  if (claimant != -1 && claimant != agent_id && claimant != parent_id) {
+    fixed_move_broken = true;
+  }
+  occupied_next[from] = agent_id;
+  touched.push_back(from);
+  next[agent_id] = from;
+  return false;
+}
+
+std::vector<std::vector<std::shared_ptr<Cell>>> PIBT::ToSolution(const std::vector<std::vector<int>>& configurations) const {
+  std::vector<std::vector<std::shared_ptr<Cell>>> solution(agents.size());
+
+  for (size_t i = 0; i < agents.size(); i++) {
+    // Cut the path after the agent's last arrival at its goal
+    size_t length = configurations.size();
+    while (length > 1 && configurations[length - 1][i] == goals[i] && configurations[length - 2][i] == goals[i]) {
+      length--;
+    }
+
+    solution[i].reserve(length);
+    for (size_t t = 0; t < length; t++) {
+      int index = configurations[t][i];
+      solution[i].push_back(map->GetCell(map->GetRow(index), map->GetCol(index)));
+    }
+  }
+
+  return solution;
+}
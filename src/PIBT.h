@@ -0,0 +1,135 @@
+/**
+ * @file PIBT.h
+ * @brief Defines the Priority Inheritance with Backtracking (PIBT) engine.
+ *
+ * PIBT plans one time step at a time for all agents on the flat grid of
+ * Map. Each agent tries its neighbors in order of distance to its goal,
+ * read from per-goal distance tables;
+ * an agent that wants an occupied cell passes its priority to the occupant,
+ * which must move away first or report back that it cannot.
+ */
+
+#ifndef PIBT_H
+#define PIBT_H
+
+#include <vector>
+#include <memory>
+#include <random>
+#include "Map.h"
+#include "Agent.h"
+#include "Solver.h"
+#include "DistanceTable.h"
+
+/**
+ * @brief Implements PIBT for large numbers of agents.
+ *
+ * A configuration is one flat cell index per agent. Step() turns the
+ * current configuration into the next one; PathFind() repeats it until
+ * every agent rests at its goal.
+ */
+class PIBT : public Solver {
+public:
+    /**
+     * @brief Constructs a new PIBT solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    PIBT(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Sets the number of time steps after which planning gives up.
+     *
+     * @param timesteps Maximum makespan
+     */
+    void SetMaxTimesteps(int timesteps);
+
+    /**
+     * @brief Seeds the random tie-breaking.
+     *
+     * @param seed Seed value
+     */
+    void SetSeed(unsigned int seed);
+
+    /**
+     * @brief Plans time steps until all agents are at their goals.
+     *
+     * @return true if every agent reached its goal within the step limit
+     */
+    bool PathFind() override;
+
+    /**
+     * @brief Loads the agents' goals and distance tables.
+     *
+     * Called by PathFind(); engines that drive Step() directly call it once.
+     *
+     * @return false if some agent cannot reach its goal
+     */
+    bool Initialize();
+
+    /**
+     * @brief Computes the next configuration from the current one.
+     *
+     * Entries of next that are not -1 are treated as fixed moves; all other
+     * agents are planned in the given priority order.
+     *
+     * @param current Cell index of every agent now
+     * @param next Cell index of every agent at the next step, -1 where free
+     * @param order Agents sorted from highest to lowest priority
+     * @return false if the fixed moves could not be completed without conflicts
+     */
+    bool Step(const std::vector<int>& current, std::vector<int>& next, const std::vector<int>& order);
+
+    /**
+     * @brief Gets the number of moves from a cell to an agent's goal.
+     *
+     * @param agent_id Agent index
+     * @param index Flat cell index
+     * @return Move count, Map::UNREACHABLE if the goal cannot be reached
+     */
+    int GetDistance(int agent_id, int index) { return distance_tables[agent_id]->Get(index); }
+
+    /**
+     * @brief Gets the flat goal cell of every agent.
+     */
+    const std::vector<int>& GetGoals() const { return goals; }
+
+    /**
+     * @brief Gets the flat start cell of every agent.
+     */
+    const std::vector<int>& GetStarts() const { return starts; }
+
+    /**
+     * @brief Converts a sequence of configurations into per-agent paths.
+     *
+     * Each path is cut after the agent's last arrival at its goal.
+     *
+     * @param configurations Configurations indexed by time step
+     * @return One path per agent
+     */
+    std::vector<std::vector<std::shared_ptr<Cell>>> ToSolution(const std::vector<std::vector<int>>& configurations) const;
+
+private:
+    int max_timesteps;                 ///< Step limit
+    std::mt19937 rng;                  ///< Random number generator for tie-breaking
+    std::vector<int> starts;           ///< Start cell per agent
+    std::vector<int> goals;            ///< Goal cell per agent
+    std::vector<std::shared_ptr<DistanceTable>> distance_tables;  ///< Distance-to-goal per agent (shared per goal)
+    std::vector<int> occupied_now;     ///< Cell -> agent at the current step, -1 if free
+    std::vector<int> occupied_next;    ///< Cell -> agent at the next step, -1 if free
+    std::vector<int> touched;          ///< Cells written to occupied_next during the current step
+    bool fixed_move_broken;            ///< Set when an agent had to stay in a cell claimed by a fixed move
+
+    /**
+     * @brief Moves one agent, recursively pushing the agent in its way.
+     *
+     * @param agent_id Agent to move
+     * @param parent_id Agent that inherited its priority to agent_id, -1 if none
+     * @param current Cell index of every agent now
+     * @param next Cell index of every agent at the next step
+     * @return false if the agent had to stay and its parent must try elsewhere
+     */
+    bool Push(int agent_id, int parent_id, const std::vector<int>& current, std::vector<int>& next);
+};
+
+#endif // PIBT_H
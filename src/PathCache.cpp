@@ -0,0 +1,52 @@
+#include "PathCache.h"
+
+PathCache::PathCache(size_t _capacity) : capacity(_capacity) {}
+
+uint64_t PathCache::Key(int agent_id, uint64_t constraint_hash) {
+  // The constraint hash is already mixed; spread the agent id over all bits before combining
+  uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(agent_id)) * 0x9e3779b97f4a7c15ULL;
+  return constraint_hash ^ (x ^ (x >> 32));
+}
+
+bool PathCache::Lookup(int agent_id, uint64_t constraint_hash, std::vector<std::shared_ptr<Cell>>& path) {
+  auto it = index.find(Key(agent_id, constraint_hash));
+  if (it == index.end() || it->second->agent_id != agent_id || it->second->constraint_hash != constraint_hash) {
+    misses++;
+    return false;
+  }
+
+  hits++;
+  entries.splice(entries.begin(), entries, it->second);
+  path = it->second->path;
+  return true;
+}
+
+void PathCache::Insert(int agent_id, uint64_t constraint_hash, const std::vector<std::shared_ptr<Cell>>& path) {
+  if (capacity == 0) {
+    return;
+  }
+
+  uint64_t key = Key(agent_id, constraint_hash);
+  auto it = index.find(key);
+  if (it != index.end()) {
+    // Same key: replace the entry in place
+    it->second->agent_id = agent_id;
+    it->second->constraint_hash = constraint_hash;
+    it->second->path = path;
+    entries.splice(entries.begin(), entries, it->second);
+    return;
+  }
+
+  if (entries.size() >= capacity) {
+    index.erase(Key(entries.back().agent_id, entries.back().constraint_hash));
+    entries.pop_back();
+  }
+
+  entries.push_front({agent_id, constraint_hash, path});
+  index[key] = entries.begin();
+}
+
+double PathCache::GetHitRate() const {
+  size_t lookups = hits + misses;
+  return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+}
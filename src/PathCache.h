@@ -0,0 +1,93 @@
+/**
+ * @file PathCache.h
+ * @brief Defines the bounded cache of low-level paths used by CBS.
+ *
+ * Across the constraint tree the same agent is often replanned under the
+ * same constraints on that agent, for example when the sibling branch only
+ * constrained the other agent. The cache remembers the result of such a
+ * search, including the fact that no path exists, so it is only run once.
+ */
+
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <vector>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include "Map.h"
+
+/**
+ * @brief Least-recently-used cache of paths keyed by agent and constraint hash.
+ *
+ * Only valid while the start, goal and search settings of every agent stay
+ * the same, so each CBS search owns its own cache.
+ */
+class PathCache {
+public:
+    /**
+     * @brief Constructs an empty cache.
+     *
+     * @param _capacity Maximum number of stored paths, 0 disables the cache
+     */
+    explicit PathCache(size_t _capacity);
+
+    /**
+     * @brief Looks up the path of an agent under a set of constraints.
+     *
+     * A hit marks the entry as most recently used.
+     *
+     * @param agent_id ID of the agent
+     * @param constraint_hash Hash of the constraints on this agent
+     * @param path Output path; empty if the cached search found no path
+     * @return true if the cache held an entry
+     */
+    bool Lookup(int agent_id, uint64_t constraint_hash, std::vector<std::shared_ptr<Cell>>& path);
+
+    /**
+     * @brief Stores the result of a search, evicting the least recently used entry if full.
+     *
+     * @param agent_id ID of the agent
+     * @param constraint_hash Hash of the constraints on this agent
+     * @param path Path found, empty if no path exists
+     */
+    void Insert(int agent_id, uint64_t constraint_hash, const std::vector<std::shared_ptr<Cell>>& path);
+
+    /**
+     * @brief Gets the number of lookups that found an entry.
+     */
+    size_t GetHits() const { return hits; }
+
+    /**
+     * @brief Gets the number of lookups that found no entry.
+     */
+    size_t GetMisses() const { return misses; }
+
+    /**
+     * @brief Gets the fraction of lookups that found an entry.
+     *
+     * @return Hit rate in [0, 1], 0 if nothing was looked up
+     */
+    double GetHitRate() const;
+
+private:
+    /**
+     * @brief A cached search result.
+     */
+    struct Entry {
+        int agent_id;                              ///< ID of the agent
+        uint64_t constraint_hash;                  ///< Hash of the constraints on the agent
+        std::vector<std::shared_ptr<Cell>> path;   ///< Path found, empty if none exists
+    };
+
+    size_t capacity;  ///< Maximum number of entries
+    size_t hits = 0;  ///< Lookups that found an entry
+    size_t misses = 0;  ///< Lookups that found no entry
+    std::list<Entry> entries;  ///< Entries, most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;  ///< Key -> entry
+
+    static uint64_t Key(int agent_id, uint64_t constraint_hash);
+};
+
+#endif // PATH_CACHE_H
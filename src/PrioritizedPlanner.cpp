@@ -0,0 +1,51 @@
+#include "PrioritizedPlanner.h"
+#include <numeric>
+
+PrioritizedPlanner::PrioritizedPlanner(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents)
+  : Solver(_map, _agents), priority_order(_agents.size()) {
+  // Default to the scenario order
+  std::iota(priority_order.begin(), priority_order.end(), 0);
+}
+
+void PrioritizedPlanner::SetPriorityOrder(const std::vector<int>& order) {
+  priority_order = order;
+}
+
+bool PrioritizedPlanner::PathFind() {
+  BeginPathFind();
+  AStar astar(map);
+  astar.SetDeadline(deadline);
+  ReservationTable reservations;
+  std::vector<std::vector<std::shared_ptr<Cell>>> solution(agents.size());
+
+  for (int agent_id : priority_order) {
+    const AgentData& data = agents[agent_id]->GetAgentData();
+    auto path = astar.FindPath(data.start_row, data.start_col, data.dest_row, data.dest_col,
+                               agent_id, 0, reservations);
+    stats.AddSearch(astar.GetLastStats());
+
+    if (path.empty()) {
+      if (DeadlinePassed()) {
+        if (verbose) {
+          std::cerr << "Prioritized planning reached its deadline at agent " << agent_id << std::endl;
+        }
+        return false;
+      }
+      if (verbose) {
+        std::cerr << "Prioritized planning failed for agent " << agent_id << std::endl;
+      }
+      return false;
+    }
+
+    reservations.ReservePath(path, agent_id);
+    solution[agent_id] = path;
+  }
+
+  // Publish the final solution to the map and the agents
+  ApplySolution(solution);
+
+  if (verbose) {
+    std::cout << "Solution found with cost: " << CalculateSolutionCost(solution) << std::endl;
+  }
+  return true;
+}
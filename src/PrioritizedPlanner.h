@@ -0,0 +1,53 @@
+/**
+ * @file PrioritizedPlanner.h
+ * @brief Defines the prioritized planning engine.
+ *
+ * Prioritized planning plans agents one after another in a fixed priority
+ * order. Each agent avoids the paths of all agents planned before it through
+ * a space-time reservation table. The result is fast but neither optimal
+ * nor complete.
+ */
+
+#ifndef PRIORITIZED_PLANNER_H
+#define PRIORITIZED_PLANNER_H
+
+#include <vector>
+#include <memory>
+#include "Map.h"
+#include "Agent.h"
+#include "AStar.h"
+#include "Solver.h"
+#include "ReservationTable.h"
+
+/**
+ * @brief Implements prioritized planning with a reservation table.
+ */
+class PrioritizedPlanner : public Solver {
+public:
+    /**
+     * @brief Constructs a new prioritized planner.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    PrioritizedPlanner(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    /**
+     * @brief Sets the order in which agents are planned.
+     *
+     * @param order Agent indices, highest priority first
+     */
+    void SetPriorityOrder(const std::vector<int>& order);
+
+    /**
+     * @brief Plans all agents in priority order.
+     *
+     * @return true if every agent found a path
+     */
+    bool PathFind() override;
+
+private:
+    std::vector<int> priority_order;  ///< Agent indices, highest priority first
+};
+
+#endif // PRIORITIZED_PLANNER_H
@@ -0,0 +1,69 @@
+#include "ReservationTable.h"
+#include <climits>
+
+// Pack (row, col) into the low 40 bits and the time step above them
+long long ReservationTable::CellKey(int row, int col) {
+  return (static_cast<long long>(row) << 20) | static_cast<long long>(col);
+}
+
+long long ReservationTable::Key(int row, int col, int time) {
+  return (static_cast<long long>(time) << 40) | CellKey(row, col);
+}
+
+void ReservationTable::ReservePath(const std::vector<std::shared_ptr<Cell>>& path, int agent_id) {
+  if (path.empty()) {
+    return;
+  }
+
+  for (size_t t = 0; t < path.size(); t++) {
+    vertex_reservations[Key(path[t]->row, path[t]->col, t)] = agent_id;
+
+    int& last = last_reserved_time.emplace(CellKey(path[t]->row, path[t]->col), -1).first->second;
+    last = std::max(last, static_cast<int>(t));
+  }
+
+  // The agent stays at its goal once the path ends
+  const auto& goal = path.back();
+  goal_reservations[CellKey(goal->row, goal->col)] = {static_cast<int>(path.size()) - 1, agent_id};
+  last_reserved_time[CellKey(goal->row, goal->col)] = INT_MAX;
+  max_time = std::max(max_time, static_cast<int>(path.size()) - 1);
+}
+
+void ReservationTable::Clear() {
+  vertex_reservations.clear();
+  goal_reservations.clear();
+  last_reserved_time.clear();
+  max_time = -1;
+}
+
+int ReservationTable::GetAgentAt(int row, int col, int time) const {
+  auto it = vertex_reservations.find(Key(row, col, time));
+  if (it != vertex_reservations.end()) {
+    return it->second;
+  }
+
+  auto goal_it = goal_reservations.find(CellKey(row, col));
+  if (goal_it != goal_reservations.end() && time >= goal_it->second.first) {
+    return goal_it->second.second;
+  }
+
+  return -1;
+}
+
+bool ReservationTable::IsVertexReserved(int row, int col, int time) const {
+  return GetAgentAt(row, col, time) != -1;
+}
+
+bool ReservationTable::IsEdgeReserved(int row1, int col1, int row2, int col2, int time) const {
+  int agent_id = GetAgentAt(row2, col2, time);
+  return agent_id != -1 && GetAgentAt(row1, col1, time + 1) == agent_id;
+}
+
+int ReservationTable::GetLastReservedTime(int row, int col) const {
+  auto it = last_reserved_time.find(CellKey(row, col));
+  return it != last_reserved_time.end() ? it->second : -1;
+}
+
+int ReservationTable::GetMaxTime() const {
+  return max_time;
+}
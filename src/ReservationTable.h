@@ -0,0 +1,98 @@
+/**
+ * @file ReservationTable.h
+ * @brief Defines the space-time reservation table used by prioritized engines.
+ *
+ * Prioritized planners do not branch on conflicts. Instead, every planned
+ * path is reserved in this table and later agents plan around it. An agent
+ * that reaches the end of its path keeps its goal cell reserved forever.
+ */
+
+#ifndef RESERVATION_TABLE_H
+#define RESERVATION_TABLE_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "Map.h"
+
+/**
+ * @brief Stores which agent occupies a cell at a given time step.
+ */
+class ReservationTable {
+public:
+    /**
+     * @brief Reserves every step of a path for an agent.
+     *
+     * The last cell of the path stays reserved for all later time steps.
+     *
+     * @param path Path to reserve, indexed by time step
+     * @param agent_id ID of the agent following the path
+     */
+    void ReservePath(const std::vector<std::shared_ptr<Cell>>& path, int agent_id);
+
+    /**
+     * @brief Removes all reservations.
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the agent that reserved a cell at a time step.
+     *
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @param time Time step
+     * @return Agent ID if reserved, -1 otherwise
+     */
+    int GetAgentAt(int row, int col, int time) const;
+
+    /**
+     * @brief Checks if a cell is reserved at a time step.
+     *
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @param time Time step
+     * @return true if any agent reserved the cell
+     */
+    bool IsVertexReserved(int row, int col, int time) const;
+
+    /**
+     * @brief Checks if a move would swap positions with a reserved agent.
+     *
+     * @param row1 Starting row
+     * @param col1 Starting column
+     * @param row2 Ending row
+     * @param col2 Ending column
+     * @param time Time step at which the move starts
+     * @return true if another agent moves from (row2, col2) to (row1, col1) at the same time
+     */
+    bool IsEdgeReserved(int row1, int col1, int row2, int col2, int time) const;
+
+    /**
+     * @brief Gets the last time step at which a cell is reserved.
+     *
+     * @param row Row coordinate
+     * @param col Column coordinate
+     * @return Last reserved time, -1 if never reserved, INT_MAX if held as a goal
+     */
+    int GetLastReservedTime(int row, int col) const;
+
+    /**
+     * @brief Gets the last time step at which any reservation changes.
+     *
+     * After this time step the reserved cells stay the same forever.
+     *
+     * @return Last time step with a time-dependent reservation, -1 if empty
+     */
+    int GetMaxTime() const;
+
+private:
+    std::unordered_map<long long, int> vertex_reservations;  ///< (time, row, col) -> agent_id
+    std::unordered_map<long long, std::pair<int, int>> goal_reservations;  ///< (row, col) -> (from time, agent_id)
+    std::unordered_map<long long, int> last_reserved_time;  ///< (row, col) -> last reserved time step
+    int max_time = -1;  ///< Last time step with a time-dependent reservation
+
+    static long long CellKey(int row, int col);
+    static long long Key(int row, int col, int time);
+};
+
+#endif // RESERVATION_TABLE_H
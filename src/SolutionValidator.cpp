@@ -0,0 +1,324 @@
+#include "SolutionValidator.h"
+#include "SolutionWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Reads a decimal integer, with an optional minus sign
+bool ParseInt(const char*& pos, const char* end, int& value) {
+  bool negative = pos < end && *pos == '-';
+  if (negative) {
+    pos++;
+  }
+  if (pos >= end || *pos < '0' || *pos > '9') {
+    return false;
+  }
+  long long number = 0;
+  while (pos < end && *pos >= '0' && *pos <= '9' && number <= INT32_MAX) {
+    number = number * 10 + (*pos++ - '0');
+  }
+  value = static_cast<int>(negative ? -number : number);
+  return number <= INT32_MAX;
+}
+
+void SkipBlanks(const char*& pos, const char* end) {
+  while (pos < end && (*pos == ' ' || *pos == '\t')) {
+    pos++;
+  }
+}
+
+uint32_t ReadUint32(const unsigned char* bytes) {
+  return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+// Parses "Agent <id>:(row,col)->(row,col)->..." lines
+std::vector<AgentPath> ReadTextSolution(const MappedFile& file, const std::string& path, const Map& map) {
+  std::vector<AgentPath> paths;
+  TextScanner scanner(file.Data(), file.Data() + file.Size());
+  const char* line;
+  size_t length;
+  int line_number = 0;
+  while (scanner.NextLine(line, length)) {
+    line_number++;
+    const char* pos = line;
+    const char* end = line + length;
+    SkipBlanks(pos, end);
+    if (pos == end) {
+      continue;  // Tolerate blank lines
+    }
+
+    AgentPath agent_path;
+    bool valid = static_cast<size_t>(end - pos) > 5 && std::memcmp(pos, "Agent", 5) == 0;
+    if (valid) {
+      pos += 5;
+      SkipBlanks(pos, end);
+      valid = ParseInt(pos, end, agent_path.agent_id) && pos < end && *pos++ == ':';
+    }
+    while (valid) {
+      SkipBlanks(pos, end);
+      if (pos == end) {
+        break;
+      }
+      int row, col;
+      valid = *pos++ == '(' && ParseInt(pos, end, row) && pos < end && *pos++ == ',' &&
+              ParseInt(pos, end, col) && pos < end && *pos++ == ')';
+      if (valid) {
+        agent_path.cells.push_back(map.IsInBounds(row, col) ? map.GetIndex(row, col) : -1);
+        if (end - pos >= 2 && pos[0] == '-' && pos[1] == '>') {
+          pos += 2;
+        }
+      }
+    }
+    if (!valid) {
+      throw std::runtime_error("Malformed line " + std::to_string(line_number) + " in solution file: " + path);
+    }
+    paths.push_back(std::move(agent_path));
+  }
+  return paths;
+}
+
+// Decodes the binary format of SolutionWriter
+std::vector<AgentPath> ReadBinarySolution(const MappedFile& file, const std::string& path, const Map& map) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(file.Data());
+  const size_t size = file.Size();
+  const size_t header_size = 24;
+  if (size < header_size) {
+    throw std::runtime_error("Truncated solution file: " + path);
+  }
+  int width = static_cast<int>(ReadUint32(bytes + 8));
+  int height = static_cast<int>(ReadUint32(bytes + 12));
+  int bits_per_move = bytes[17];
+  uint32_t agent_count = ReadUint32(bytes + 20);
+  if (width != map.GetWidth() || height != map.GetHeight()) {
+    throw std::runtime_error("Solution file " + path + " is for a " + std::to_string(width) + "x" +
+                             std::to_string(height) + " map, not for map " + map.GetName());
+  }
+  if (bits_per_move < 3 || bits_per_move > 4) {
+    throw std::runtime_error("Unsupported move width in solution file: " + path);
+  }
+
+  std::vector<AgentPath> paths;
+  paths.reserve(std::min<size_t>(agent_count, size / 12));
+  size_t offset = header_size;
+  const uint32_t mask = (1u << bits_per_move) - 1;
+  for (uint32_t i = 0; i < agent_count; i++) {
+    if (size - offset < 12) {
+      throw std::runtime_error("Truncated solution file: " + path);
+    }
+    AgentPath agent_path;
+    agent_path.agent_id = static_cast<int>(ReadUint32(bytes + offset));
+    uint32_t start = ReadUint32(bytes + offset + 4);
+    uint32_t moves = ReadUint32(bytes + offset + 8);
+    offset += 12;
+    size_t move_bytes = (static_cast<size_t>(moves) * bits_per_move + 7) / 8;
+    if (size - offset < move_bytes || start >= static_cast<uint32_t>(map.GetCellCount())) {
+      throw std::runtime_error("Malformed path of agent " + std::to_string(agent_path.agent_id) +
+                               " in solution file: " + path);
+    }
+
+    // Follow the moves by row and column, so steps off the map are caught rather than wrapped
+    const size_t moves_offset = offset;
+    int row = map.GetRow(start);
+    int col = map.GetCol(start);
+    agent_path.cells.reserve(moves + 1);
+    agent_path.cells.push_back(start);
+    uint64_t bits = 0;
+    int bit_count = 0;
+    for (uint32_t t = 0; t < moves; t++) {
+      if (bit_count < bits_per_move) {
+        bits |= static_cast<uint64_t>(bytes[offset++]) << bit_count;
+        bit_count += 8;
+      }
+      int row_change, col_change;
+      if (!SolutionWriter::DecodeMove(bits & mask, row_change, col_change)) {
+        throw std::runtime_error("Invalid move code of agent " + std::to_string(agent_path.agent_id) +
+                                 " in solution file: " + path);
+      }
+      bits >>= bits_per_move;
+      bit_count -= bits_per_move;
+      row += row_change;
+      col += col_change;
+      agent_path.cells.push_back(map.IsInBounds(row, col) ? map.GetIndex(row, col) : -1);
+    }
+    offset = moves_offset + move_bytes;
+    paths.push_back(std::move(agent_path));
+  }
+  return paths;
+}
+
+}  // namespace
+
+SolutionValidator::SolutionValidator(const Map& _map)
+  : map(_map), max_violations(DEFAULT_MAX_VIOLATIONS) {}
+
+std::vector<AgentPath> SolutionValidator::ReadSolution(const std::string& path, const Map& map) {
+  MappedFile file(path);
+  if (!file.IsOpen()) {
+    throw std::runtime_error("Failed to open solution file: " + path);
+  }
+  if (file.Size() >= 8 && std::memcmp(file.Data(), SolutionWriter::BINARY_MAGIC, 8) == 0) {
+    return ReadBinarySolution(file, path, map);
+  }
+  return ReadTextSolution(file, path, map);
+}
+
+void SolutionValidator::SetMaxViolations(int count) {
+  max_violations = std::max(1, count);
+}
+
+bool SolutionValidator::Validate(const std::vector<AgentData>& agents, const std::vector<AgentPath>& paths) {
+  violations.clear();
+  makespan = 0;
+  sum_of_costs = 0;
+
+  // Match the paths to the scenario agents
+  const int agent_count = static_cast<int>(agents.size());
+  std::vector<const std::vector<int>*> agent_paths(agent_count, nullptr);
+  for (const AgentPath& path : paths) {
+    if (path.agent_id < 0 || path.agent_id >= agent_count || agent_paths[path.agent_id]) {
+      if (!Report({ViolationType::EXTRA_PATH, 0, path.agent_id})) return false;
+      continue;
+    }
+    agent_paths[path.agent_id] = &path.cells;
+  }
+
+  // Check the ends of every path
+  for (int a = 0; a < agent_count; a++) {
+    const std::vector<int>* cells = agent_paths[a];
+    if (!cells || cells->empty()) {
+      agent_paths[a] = nullptr;
+      if (!Report({ViolationType::MISSING_PATH, 0, a})) return false;
+      continue;
+    }
+    int last = static_cast<int>(cells->size()) - 1;
+    sum_of_costs += cells->size();
+    makespan = std::max(makespan, last);
+
+    const AgentData& agent = agents[a];
+    int start = map.IsInBounds(agent.start_row, agent.start_col) ? map.GetIndex(agent.start_row, agent.start_col) : -1;
+    int goal = map.IsInBounds(agent.dest_row, agent.dest_col) ? map.GetIndex(agent.dest_row, agent.dest_col) : -1;
+    if (cells->front() != start && !Report({ViolationType::START, 0, a, -1, cells->front(), start})) return false;
+    if (cells->back() != goal && !Report({ViolationType::GOAL, last, a, -1, cells->back(), goal})) return false;
+  }
+
+  // Sweep over time through the agents still moving; an agent leaves the sweep at its last step and parks
+  occupancy.assign(map.GetCellCount(), CellState());
+  std::vector<int> moving;
+  for (int a = 0; a < agent_count; a++) {
+    if (agent_paths[a]) {
+      moving.push_back(a);
+    }
+  }
+  std::vector<uint8_t> reported(agent_count, 0);  // Agents whose own moves already broke a rule
+  std::vector<int> positions(agent_count, -1);    // Cell of each agent at this step once it is swept, else at the last
+  for (int t = 0; !moving.empty(); t++) {
+    // Agents stay in ID order, so their paths are visited in memory order
+    const size_t moving_count = moving.size();
+    size_t still_moving = 0;
+    for (size_t i = 0; i < moving_count; i++) {
+      const int a = moving[i];
+      const std::vector<int>& cells = *agent_paths[a];
+      const int cell = cells[t];
+      const int previous_cell = t > 0 ? cells[t - 1] : -1;
+      const bool last_step = t + 1 == static_cast<int>(cells.size());
+      if (!last_step) {
+        moving[still_moving++] = a;
+      }
+
+      if (!reported[a]) {
+        ViolationType type;
+        bool broken = true;
+        if (cell < 0) {
+          type = ViolationType::OFF_MAP;
+        } else if (!map.IsPassable(cell)) {
+          type = ViolationType::OBSTACLE;
+        } else if (previous_cell >= 0 && previous_cell != cell && !map.IsNeighbor(previous_cell, cell)) {
+          type = ViolationType::ILLEGAL_MOVE;
+        } else {
+          broken = false;
+        }
+        if (broken) {
+          reported[a] = 1;
+          if (!Report({type, t, a, -1, cell, previous_cell})) return false;
+        }
+      }
+      if (cell < 0) {
+        continue;
+      }
+
+      CellState& state = occupancy[cell];
+      if (state.time == t) {
+        // Another agent entered this cell earlier in the same step
+        if (!Report({ViolationType::VERTEX_CONFLICT, t, state.agent, a, cell})) return false;
+      } else {
+        // The agent here one step ago swapped with this one if it already moved on to where this one
+        // came from; if it comes later in the step, it finds the swap itself
+        if (state.time == t - 1 && previous_cell >= 0 && previous_cell != cell &&
+            positions[state.agent] == previous_cell &&
+            !Report({ViolationType::SWAP_CONFLICT, t, state.agent, a, previous_cell, cell})) {
+          return false;
+        }
+        state.time = t;
+        state.agent = a;
+      }
+      positions[a] = cell;
+
+      // An agent that arrived for good earlier blocks the cell from then on
+      if (state.parked_agent >= 0 && state.parked_time < t) {
+        if (!Report({ViolationType::VERTEX_CONFLICT, t, state.parked_agent, a, cell})) return false;
+      } else if (last_step && state.parked_agent < 0) {
+        state.parked_time = t;
+        state.parked_agent = a;
+      }
+    }
+    moving.resize(still_moving);
+  }
+  return violations.empty();
+}
+
+std::string SolutionValidator::Describe(const Violation& violation) const {
+  const std::string agent = "Agent " + std::to_string(violation.agent);
+  const std::string at_time = " at time " + std::to_string(violation.time);
+  switch (violation.type) {
+    case ViolationType::MISSING_PATH:
+      return agent + " has no path";
+    case ViolationType::EXTRA_PATH:
+      return "Path of agent " + std::to_string(violation.agent) + " matches no other agent of the scenario";
+    case ViolationType::START:
+      return agent + " starts at " + FormatCell(violation.cell) + " instead of " + FormatCell(violation.other_cell);
+    case ViolationType::GOAL:
+      return agent + " ends at " + FormatCell(violation.cell) + at_time + " instead of its goal " +
+             FormatCell(violation.other_cell);
+    case ViolationType::OFF_MAP:
+      return agent + " leaves the map" + at_time + ", coming from " + FormatCell(violation.other_cell);
+    case ViolationType::OBSTACLE:
+      return agent + " is on the obstacle " + FormatCell(violation.cell) + at_time;
+    case ViolationType::ILLEGAL_MOVE:
+      return agent + " moves from " + FormatCell(violation.other_cell) + " to " + FormatCell(violation.cell) +
+             at_time + ", which are not neighbors";
+    case ViolationType::VERTEX_CONFLICT:
+      return "Agents " + std::to_string(violation.agent) + " and " + std::to_string(violation.other_agent) +
+             " are both at " + FormatCell(violation.cell) + at_time;
+    case ViolationType::SWAP_CONFLICT:
+      return "Agents " + std::to_string(violation.agent) + " and " + std::to_string(violation.other_agent) +
+             " swap " + FormatCell(violation.other_cell) + " and " + FormatCell(violation.cell) +
+             " between time " + std::to_string(violation.time - 1) + " and " + std::to_string(violation.time);
+  }
+  return agent + at_time;
+}
+
+bool SolutionValidator::Report(const Violation& violation) {
+  violations.push_back(violation);
+  return static_cast<int>(violations.size()) < max_violations;
+}
+
+std::string SolutionValidator::FormatCell(int cell) const {
+  if (cell < 0) {
+    return "(outside the map)";
+  }
+  return "(" + std::to_string(map.GetRow(cell)) + "," + std::to_string(map.GetCol(cell)) + ")";
+}
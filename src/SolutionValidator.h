@@ -0,0 +1,164 @@
+/**
+ * @file SolutionValidator.h
+ * @brief Defines the standalone checker of solution files.
+ *
+ * The validator does not trust the engine that produced a solution: it
+ * reads the paths from a file written by SolutionWriter, in either format,
+ * and checks them against the map and the scenario alone.
+ *
+ * All checks run in one sweep over time. At every time step each moving
+ * agent is entered into a flat occupancy table indexed by cell, which is
+ * stamped with the time instead of being cleared. The entry an agent
+ * replaces names the agent that was in the cell one step earlier; if that
+ * agent has moved to where the first one came from, they swapped. As in
+ * the engines, an agent whose path has ended stays at its last cell: it
+ * leaves the sweep and is parked in the table. The work is proportional
+ * to the sum of costs, at most O(agents x makespan), with no per-pair
+ * checks.
+ */
+
+#ifndef SOLUTION_VALIDATOR_H
+#define SOLUTION_VALIDATOR_H
+
+#include <vector>
+#include <string>
+#include "Map.h"
+#include "Agent.h"
+
+/**
+ * @brief Path of one agent as read from a solution file.
+ */
+struct AgentPath {
+    int agent_id;            ///< ID of the agent, its position in the scenario
+    std::vector<int> cells;  ///< Flat cell index per time step, -1 outside the map
+};
+
+/**
+ * @brief Kind of rule a solution breaks.
+ */
+enum class ViolationType {
+    MISSING_PATH,     ///< A scenario agent has no path, or an empty one
+    EXTRA_PATH,       ///< A path belongs to no scenario agent, or repeats an agent
+    START,            ///< The path does not begin at the agent's start
+    GOAL,             ///< The path does not end at the agent's goal
+    OFF_MAP,          ///< The agent leaves the map
+    OBSTACLE,         ///< The agent enters an obstacle
+    ILLEGAL_MOVE,     ///< The agent moves to a cell that is not a neighbor
+    VERTEX_CONFLICT,  ///< Two agents are in the same cell at the same time
+    SWAP_CONFLICT     ///< Two agents trade cells in the same time step
+};
+
+/**
+ * @brief One broken rule, with where and when it happened.
+ */
+struct Violation {
+    ViolationType type;    ///< Rule that is broken
+    int time;              ///< Time step of the violation; a swap is reported at its arrival time
+    int agent;             ///< Agent that breaks the rule
+    int other_agent = -1;  ///< Second agent of a conflict
+    int cell = -1;         ///< Cell of the agent at that time, -1 if unknown
+    int other_cell = -1;   ///< Expected cell, previous cell of a move, or the cell left in a swap
+};
+
+/**
+ * @brief Checks solutions against a map and the start and goal of each agent.
+ */
+class SolutionValidator {
+public:
+    /// Violations collected before a check stops
+    static const int DEFAULT_MAX_VIOLATIONS = 10;
+
+    /**
+     * @brief Constructs a validator for a map.
+     *
+     * @param _map Map the solutions are on; must outlive the validator
+     */
+    explicit SolutionValidator(const Map& _map);
+
+    /**
+     * @brief Reads a solution file in the text or the binary format.
+     *
+     * The format is told apart by the magic bytes of the binary header.
+     *
+     * @param path Solution file
+     * @param map Map the solution is on, to number the cells
+     * @return One entry per path, in file order
+     * @throw std::runtime_error if the file cannot be read, is malformed, or is for a map of another size
+     */
+    static std::vector<AgentPath> ReadSolution(const std::string& path, const Map& map);
+
+    /**
+     * @brief Sets how many violations are collected before a check stops.
+     *
+     * @param count Largest number of violations reported
+     */
+    void SetMaxViolations(int count);
+
+    /**
+     * @brief Checks a solution.
+     *
+     * Violations are collected in time order, after the checks of the
+     * paths' ends, until the limit is reached.
+     *
+     * @param agents Scenario entries; path i must belong to the agent with ID i
+     * @param paths Paths to check
+     * @return true if the solution breaks no rule
+     */
+    bool Validate(const std::vector<AgentData>& agents, const std::vector<AgentPath>& paths);
+
+    /**
+     * @brief Gets the violations found by the last check, at most the limit.
+     */
+    const std::vector<Violation>& GetViolations() const { return violations; }
+
+    /**
+     * @brief Gets the last time step of the longest path of the last check.
+     */
+    int GetMakespan() const { return makespan; }
+
+    /**
+     * @brief Gets the sum of the path lengths of the last check, as the engines count cost.
+     */
+    long long GetSumOfCosts() const { return sum_of_costs; }
+
+    /**
+     * @brief Formats a violation as a sentence with agents, cells and times.
+     *
+     * @param violation Violation of the last check
+     * @return Description in (row,col) coordinates
+     */
+    std::string Describe(const Violation& violation) const;
+
+private:
+    /**
+     * @brief Entry of the occupancy table for one cell.
+     */
+    struct CellState {
+        int time = -1;          ///< Last time step an agent was entered, older entries are stale
+        int agent = -1;         ///< Agent entered at that time
+        int parked_time = -1;   ///< Time step the parked agent arrived
+        int parked_agent = -1;  ///< Agent whose path ends here, -1 if none
+    };
+
+    const Map& map;                       ///< Map the solutions are on
+    int max_violations;                   ///< Violations collected before a check stops
+    std::vector<Violation> violations;    ///< Violations of the last check
+    int makespan = 0;                     ///< Last time step of the last check
+    long long sum_of_costs = 0;           ///< Sum of the path lengths of the last check
+    std::vector<CellState> occupancy;     ///< Occupancy by cell, stamped with the time instead of cleared
+
+    /**
+     * @brief Records a violation.
+     *
+     * @param violation Violation to record
+     * @return false once the limit is reached
+     */
+    bool Report(const Violation& violation);
+
+    /**
+     * @brief Formats a cell as (row,col).
+     */
+    std::string FormatCell(int cell) const;
+};
+
+#endif // SOLUTION_VALIDATOR_H
@@ -0,0 +1,137 @@
+#include "SolutionWriter.h"
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+
+// Move code of a step, indexed by row change + 1 and column change + 1
+const int MOVE_CODES[3][3] = {{5, 1, 6}, {3, SolutionWriter::WAIT_CODE, 4}, {7, 2, 8}};
+
+// Row and column change of a step, indexed by move code
+const int MOVE_STEPS[9][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+}  // namespace
+
+SolutionWriter::SolutionWriter(const std::string& path, SolutionFormat _format, const Map& _map, int agent_count)
+  : file(path, std::ios::binary),
+    format(_format),
+    width(_map.GetWidth()),
+    bits_per_move(_map.GetMovementType() == MovementType::OCTILE ? 4 : 3) {
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot write solution file: " + path);
+  }
+  buffer.reserve(BUFFER_SIZE + 4096);
+
+  if (format == SolutionFormat::BINARY) {
+    buffer.append(BINARY_MAGIC, 8);
+    AppendUint32(width);
+    AppendUint32(_map.GetHeight());
+    buffer.push_back(_map.GetMovementType() == MovementType::OCTILE ? 1 : 0);
+    buffer.push_back(static_cast<char>(bits_per_move));
+    buffer.append(2, '\0');
+    AppendUint32(agent_count);
+  }
+}
+
+SolutionWriter::~SolutionWriter() {
+  Close();
+}
+
+SolutionFormat SolutionWriter::ParseSolutionFormat(const std::string& name) {
+  if (name == "text") return SolutionFormat::TEXT;
+  if (name == "binary") return SolutionFormat::BINARY;
+  throw std::invalid_argument("Unknown solution format: " + name);
+}
+
+int SolutionWriter::EncodeMove(int row_change, int col_change) {
+  if (row_change < -1 || row_change > 1 || col_change < -1 || col_change > 1) {
+    return -1;
+  }
+  return MOVE_CODES[row_change + 1][col_change + 1];
+}
+
+bool SolutionWriter::DecodeMove(int code, int& row_change, int& col_change) {
+  if (code < 0 || code > 8) {
+    return false;
+  }
+  row_change = MOVE_STEPS[code][0];
+  col_change = MOVE_STEPS[code][1];
+  return true;
+}
+
+void SolutionWriter::WriteAgent(int agent_id, const std::vector<std::shared_ptr<Cell>>& path) {
+  if (format == SolutionFormat::TEXT) {
+    buffer += "Agent ";
+    AppendNumber(agent_id);
+    buffer += ':';
+    for (const auto& cell : path) {
+      buffer += '(';
+      AppendNumber(cell->row);
+      buffer += ',';
+      AppendNumber(cell->col);
+      buffer += ")->";
+    }
+    buffer += '\n';
+    FlushIfFull();
+    return;
+  }
+
+  if (path.empty()) {
+    throw std::invalid_argument("Agent " + std::to_string(agent_id) + " has no path");
+  }
+  uint32_t moves = static_cast<uint32_t>(path.size() - 1);
+  AppendUint32(agent_id);
+  AppendUint32(path[0]->row * width + path[0]->col);
+  AppendUint32(moves);
+
+  // Codes are collected in a 64-bit accumulator and moved out a byte at a time
+  uint64_t bits = 0;
+  int bit_count = 0;
+  for (size_t t = 1; t < path.size(); t++) {
+    int code = EncodeMove(path[t]->row - path[t - 1]->row, path[t]->col - path[t - 1]->col);
+    if (code < 0 || (bits_per_move == 3 && code > 4)) {
+      throw std::invalid_argument("Agent " + std::to_string(agent_id) + " jumps between cells at time " +
+                                  std::to_string(t));
+    }
+    bits |= static_cast<uint64_t>(code) << bit_count;
+    bit_count += bits_per_move;
+    while (bit_count >= 8) {
+      buffer.push_back(static_cast<char>(bits & 0xFF));
+      bits >>= 8;
+      bit_count -= 8;
+    }
+  }
+  if (bit_count > 0) {
+    buffer.push_back(static_cast<char>(bits & 0xFF));
+  }
+  FlushIfFull();
+}
+
+bool SolutionWriter::Close() {
+  if (!file.is_open()) {
+    return static_cast<bool>(file);
+  }
+  file.write(buffer.data(), buffer.size());
+  buffer.clear();
+  file.close();
+  return static_cast<bool>(file);
+}
+
+void SolutionWriter::AppendUint32(uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    buffer.push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+void SolutionWriter::AppendNumber(int value) {
+  char digits[12];
+  char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+  buffer.append(digits, end);
+}
+
+void SolutionWriter::FlushIfFull() {
+  if (buffer.size() >= BUFFER_SIZE) {
+    file.write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+}
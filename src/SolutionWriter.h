@@ -0,0 +1,148 @@
+/**
+ * @file SolutionWriter.h
+ * @brief Defines the writer that streams solution paths to a file.
+ *
+ * A solution is written one agent at a time, so no second copy of all
+ * paths is built and a file can be filled as soon as paths are final.
+ * Records go into an output buffer that is flushed in large blocks.
+ *
+ * The text format is the per-agent path listing of the EECBS and MAPF-LNS
+ * planners, which their visualizers and validators read:
+ *
+ *     Agent 0:(1,1)->(1,2)->(2,2)->
+ *
+ * Coordinates are (row,col) of the map grid, one cell per time step.
+ *
+ * The binary format stores each path as its start cell and one fixed-width
+ * move code per time step, 3 bits on 4-connected maps and 4 bits on
+ * 8-connected maps. All integers are little-endian:
+ *
+ *     header  "MAPFSOL1", uint32 width, uint32 height, uint8 movement (0 Manhattan, 1 octile),
+ *             uint8 bits per move, uint16 zero, uint32 agent count
+ *     agent   uint32 agent ID, uint32 start cell (row * width + col), uint32 move count,
+ *             moves packed from the lowest bit on, padded to a whole byte
+ */
+
+#ifndef SOLUTION_WRITER_H
+#define SOLUTION_WRITER_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "Map.h"
+
+/**
+ * @brief Layout of a solution file.
+ */
+enum class SolutionFormat {
+    TEXT,   ///< One "Agent i:(row,col)->..." line per agent
+    BINARY  ///< Delta-encoded moves, a few bits per time step
+};
+
+/**
+ * @brief Streams the paths of a solution to a file, one agent at a time.
+ */
+class SolutionWriter {
+public:
+    /// Buffered output written to the file in one block
+    static const size_t BUFFER_SIZE = 1 << 16;
+
+    /// First bytes of a binary solution file
+    static constexpr char BINARY_MAGIC[9] = "MAPFSOL1";
+
+    /// Move code of waiting in place
+    static const int WAIT_CODE = 0;
+
+    /**
+     * @brief Opens the file and writes the header.
+     *
+     * @param path Output file
+     * @param _format Layout of the file
+     * @param _map Map the paths are on
+     * @param agent_count Number of agents that will be written
+     * @throw std::runtime_error if the file cannot be opened
+     */
+    SolutionWriter(const std::string& path, SolutionFormat _format, const Map& _map, int agent_count);
+
+    /**
+     * @brief Flushes the remaining output.
+     */
+    ~SolutionWriter();
+
+    /**
+     * @brief Converts a format name to a solution format.
+     *
+     * @param name "text" or "binary"
+     * @return The solution format
+     * @throw std::invalid_argument if the name is unknown
+     */
+    static SolutionFormat ParseSolutionFormat(const std::string& name);
+
+    /**
+     * @brief Gets the move code of a step between two cells.
+     *
+     * Codes are 0 for waiting and 1 to 4 for up, down, left and right; on
+     * 8-connected maps 5 to 8 are up-left, up-right, down-left and down-right.
+     *
+     * @param row_change Row of the next cell minus row of the current cell
+     * @param col_change Column of the next cell minus column of the current cell
+     * @return The move code, or -1 if the cells are not neighbors
+     */
+    static int EncodeMove(int row_change, int col_change);
+
+    /**
+     * @brief Gets the step of a move code, the inverse of EncodeMove().
+     *
+     * @param code Move code
+     * @param row_change Output: row change of the move
+     * @param col_change Output: column change of the move
+     * @return false if the code is not a move
+     */
+    static bool DecodeMove(int code, int& row_change, int& col_change);
+
+    /**
+     * @brief Appends the path of one agent.
+     *
+     * @param agent_id ID of the agent
+     * @param path Cells of the agent, one per time step
+     * @throw std::invalid_argument in the binary format if the path is empty or two consecutive cells are not neighbors
+     */
+    void WriteAgent(int agent_id, const std::vector<std::shared_ptr<Cell>>& path);
+
+    /**
+     * @brief Writes the buffered output and closes the file.
+     *
+     * @return false if any write failed
+     */
+    bool Close();
+
+private:
+    std::ofstream file;     ///< Output file
+    SolutionFormat format;  ///< Layout of the file
+    int width;              ///< Map width, to number the cells
+    int bits_per_move;      ///< Width of a move code in the binary format
+    std::string buffer;     ///< Output not yet written to the file
+
+    /**
+     * @brief Appends an unsigned 32-bit integer in little-endian byte order.
+     *
+     * @param value Value to append
+     */
+    void AppendUint32(uint32_t value);
+
+    /**
+     * @brief Appends an integer as decimal text.
+     *
+     * @param value Value to append
+     */
+    void AppendNumber(int value);
+
+    /**
+     * @brief Writes the buffer to the file once it is full.
+     */
+    void FlushIfFull();
+};
+
+#endif // SOLUTION_WRITER_H
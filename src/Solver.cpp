@@ -0,0 +1,122 @@
+#include "Solver.h"
+
+Solver::Solver(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents) : map(_map), agents(_agents) {}
+
+void Solver::BeginPathFind() {
+  stats = SolverStats();
+  timed_out = false;
+}
+
+bool Solver::DeadlinePassed() {
+  if (!timed_out && deadline != std::chrono::steady_clock::time_point::max() &&
+      std::chrono::steady_clock::now() >= deadline) {
+    timed_out = true;
+  }
+  return timed_out;
+}
+
+std::shared_ptr<Conflict> Solver::FindConflict(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution,
+                                               int window) {
+  MAPF_STATS_TIMER(conflict_timer, stats.conflict_detection_ms);
+  // Check for conflicts between each pair of agents
+  for (size_t i = 0; i < solution.size(); i++) {
+    for (size_t j = i + 1; j < solution.size(); j++) {
+      int conflict_time = 0;
+      std::shared_ptr<Conflict> conflict = std::make_shared<Conflict>();
+
+      if (HasConflict(solution[i], solution[j], conflict_time, conflict, window)) {
+        conflict->agent1_id = i;
+        conflict->agent2_id = j;
+        conflict->time = conflict_time;
+        return conflict;
+      }
+    }
+  }
+
+  return nullptr; // No conflicts found
+}
+
+bool Solver::HasConflict(const std::vector<std::shared_ptr<Cell>>& path1,
+                       const std::vector<std::shared_ptr<Cell>>& path2,
+                       int& conflict_time,
+                       std::shared_ptr<Conflict>& conflict,
+                       int window) {
+  // Get the maximum path length, cut at the window if there is one
+  size_t max_length = std::max(path1.size(), path2.size());
+  if (window > 0) {
+    max_length = std::min(max_length, static_cast<size_t>(window) + 1);
+  }
+
+  // Check for vertex conflicts (agents at the same position at the same time)
+  for (size_t t = 0; t < max_length; t++) {
+    // If path ended, assume agent stays at its last position
+    size_t idx1 = std::min(t, path1.size() - 1);
+    size_t idx2 = std::min(t, path2.size() - 1);
+
+    // Check vertex conflict
+    if (path1[idx1]->row == path2[idx2]->row && path1[idx1]->col == path2[idx2]->col) {
+      conflict_time = t;
+      conflict->type = Conflict::VERTEX;
+      conflict->row = path1[idx1]->row;
+      conflict->col = path1[idx1]->col;
+      return true;
+    }
+
+    // Check edge conflict (agents swap positions); an agent whose path ended does not move
+    if (t == 0) continue;
+    size_t prev1 = std::min(t - 1, path1.size() - 1);
+    size_t prev2 = std::min(t - 1, path2.size() - 1);
+    if (path1[idx1]->row == path2[prev2]->row && path1[idx1]->col == path2[prev2]->col &&
+      path1[prev1]->row == path2[idx2]->row && path1[prev1]->col == path2[idx2]->col) {
+
+      conflict_time = t - 1;
+      conflict->type = Conflict::EDGE;
+      conflict->row1 = path1[prev1]->row;
+      conflict->col1 = path1[prev1]->col;
+      conflict->row2 = path1[idx1]->row;
+      conflict->col2 = path1[idx1]->col;
+      return true;
+    }
+  }
+
+  return false; // No conflict found
+}
+
+int Solver::CalculateSolutionCost(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  int total_cost = 0;
+
+  for (const auto& path : solution) {
+    // Path cost is its length
+    total_cost += path.size();
+  }
+
+  return total_cost;
+}
+
+void Solver::UpdateMapWithSolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  // Reset the map first (clear all agent data)
+  map->ClearIcons();
+
+  // Add each agent's path to the map
+  for (size_t agent_id = 0; agent_id < solution.size(); agent_id++) {
+    char icon = 'A' + agent_id;  // This will give 'A', 'B', 'C', ..., for agents
+
+    for (const auto& cell : solution[agent_id]) {
+      map->MarkIcon(cell->row, cell->col, icon);
+    }
+  }
+  occupancy = std::make_shared<OccupancyTable>(*map, solution);
+  map->SetOccupancy(occupancy);
+}
+
+void Solver::ApplySolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution) {
+  // Update the map with the final solution
+  if (update_map) {
+    UpdateMapWithSolution(solution);
+  }
+
+  // Update each agent's path
+  for (size_t i = 0; i < agents.size(); i++) {
+    agents[i]->SetPath(solution[i]);
+  }
+}
@@ -0,0 +1,195 @@
+/**
+ * @file Solver.h
+ * @brief Defines the common base class for multi-agent pathfinding engines.
+ *
+ * Every engine (CBS, prioritized planning, PBS, ...) works on the same map
+ * and agent list and produces one path per agent. This file holds the
+ * shared interface and the helpers that all engines need for evaluating
+ * and publishing a solution.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include "Map.h"
+#include "Agent.h"
+#include "OccupancyTable.h"
+#include "SolverStats.h"
+
+/**
+ * @brief Represents a conflict between two agents.
+ *
+ * A conflict can be either a vertex conflict (two agents at same position)
+ * or an edge conflict (agents swapping positions). CBS may classify a
+ * vertex or edge conflict further as a corridor or rectangle conflict,
+ * which stands for a whole family of symmetric conflicts.
+ */
+struct Conflict {
+    enum Type { VERTEX, EDGE, CORRIDOR, RECTANGLE };  ///< Type of conflict
+
+    Type type;      ///< Type of conflict
+    int agent1_id;  ///< ID of first agent in conflict
+    int agent2_id;  ///< ID of second agent in conflict
+    int row;        ///< Row coordinate (for vertex conflict)
+    int col;        ///< Column coordinate (for vertex conflict)
+    int row1;       ///< Starting row (edge), first endpoint (corridor) or start corner (rectangle)
+    int col1;       ///< Starting column (edge), first endpoint (corridor) or start corner (rectangle)
+    int row2;       ///< Ending row (edge), second endpoint (corridor) or goal corner (rectangle)
+    int col2;       ///< Ending column (edge), second endpoint (corridor) or goal corner (rectangle)
+    int time;       ///< Time step of the conflict
+};
+
+/**
+ * @brief Base class for multi-agent pathfinding engines.
+ *
+ * A solver plans paths for all agents on a shared map. On success it writes
+ * the final paths back through Agent::SetPath and marks them on the map.
+ */
+class Solver {
+public:
+    /**
+     * @brief Constructs a new solver.
+     *
+     * @param _map Shared pointer to the map
+     * @param _agents Vector of shared pointers to agents
+     */
+    Solver(std::shared_ptr<Map> _map, std::vector<std::shared_ptr<Agent>>& _agents);
+
+    virtual ~Solver() = default;
+
+    /**
+     * @brief Finds conflict-free paths for all agents.
+     *
+     * @return true if a solution was found and written to the agents
+     */
+    virtual bool PathFind() = 0;
+
+    /**
+     * @brief Gets the occupancy table of the last published solution.
+     *
+     * @return The table, or nullptr if no solution was published
+     */
+    std::shared_ptr<const OccupancyTable> GetOccupancy() const { return occupancy; }
+
+    /**
+     * @brief Gets the counters and phase times of the last PathFind().
+     *
+     * High-level nodes are constraint tree nodes for CBS and Independence
+     * Detection, priority tree nodes for PBS and configurations for LaCAM.
+     */
+    const SolverStats& GetStats() const { return stats; }
+
+    /**
+     * @brief Sets a wall-clock deadline for PathFind().
+     *
+     * Checked cooperatively between high-level steps and inside the A*
+     * searches; once it has passed, PathFind() gives up and returns false.
+     *
+     * @param _deadline Point in time to stop at
+     */
+    void SetDeadline(std::chrono::steady_clock::time_point _deadline) { deadline = _deadline; }
+
+    /**
+     * @brief Checks if the last PathFind() gave up at the deadline.
+     */
+    bool TimedOut() const { return timed_out; }
+
+    /**
+     * @brief Chooses whether a published solution is also drawn on the map.
+     *
+     * Instances that share one map between threads turn this off, so they
+     * never write to it; the agents still receive their paths.
+     *
+     * @param update true to mark the paths and the occupancy on the map (the default)
+     */
+    void SetUpdateMap(bool update) { update_map = update; }
+
+    /**
+     * @brief Chooses whether PathFind() prints its result and its failures.
+     *
+     * Services that answer on standard output and batch workers that share
+     * the terminal turn this off and report results themselves.
+     *
+     * @param _verbose true to print the cost, engine summary and failure reasons (the default)
+     */
+    void SetVerbose(bool _verbose) { verbose = _verbose; }
+
+protected:
+    std::shared_ptr<Map> map;  ///< Shared pointer to the map
+    std::vector<std::shared_ptr<Agent>>& agents;  ///< Vector of agents
+    std::shared_ptr<OccupancyTable> occupancy;  ///< Occupancy of the last published solution
+    SolverStats stats;  ///< Work done by the last PathFind()
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();  ///< When PathFind() gives up
+    bool timed_out = false;  ///< Whether the last PathFind() stopped at the deadline
+    bool update_map = true;  ///< Whether ApplySolution() writes to the map
+    bool verbose = true;  ///< Whether PathFind() prints its result and failures
+
+    /**
+     * @brief Resets the statistics and the timeout flag; every PathFind() starts with it.
+     */
+    void BeginPathFind();
+
+    /**
+     * @brief Checks the deadline, remembering in TimedOut() if it has passed.
+     *
+     * @return true if PathFind() should give up
+     */
+    bool DeadlinePassed();
+
+    /**
+     * @brief Finds conflicts in the current solution.
+     *
+     * @param solution Current solution to check
+     * @param window Only report conflicts up to this time step, 0 for no limit
+     * @return Pointer to first conflict found, or nullptr if no conflicts
+     */
+    std::shared_ptr<Conflict> FindConflict(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution,
+                                           int window = 0);
+
+    /**
+     * @brief Checks for conflicts between two agents' paths.
+     *
+     * @param path1 First agent's path
+     * @param path2 Second agent's path
+     * @param conflict_time Output parameter for time of conflict
+     * @param conflict Output parameter for conflict details
+     * @param window Only check time steps up to this one, 0 for no limit
+     * @return true if a conflict exists
+     */
+    bool HasConflict(const std::vector<std::shared_ptr<Cell>>& path1,
+                    const std::vector<std::shared_ptr<Cell>>& path2,
+                    int& conflict_time,
+                    std::shared_ptr<Conflict>& conflict,
+                    int window = 0);
+
+    /**
+     * @brief Calculates the total cost of all paths.
+     *
+     * @param solution Current solution to evaluate
+     * @return Total cost of all paths
+     */
+    int CalculateSolutionCost(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+
+    /**
+     * @brief Updates the map cells with agents' paths.
+     *
+     * Rebuilds the occupancy table from the solution and hands it to the map.
+     *
+     * @param solution Current solution to visualize
+     */
+    void UpdateMapWithSolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+
+    /**
+     * @brief Publishes a final solution to the map and the agents.
+     *
+     * The map is left alone if SetUpdateMap(false) was called.
+     *
+     * @param solution Conflict-free paths for all agents
+     */
+    void ApplySolution(const std::vector<std::vector<std::shared_ptr<Cell>>>& solution);
+};
+
+#endif // SOLVER_H
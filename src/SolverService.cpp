@@ -0,0 +1,274 @@
+#include "SolverService.h"
+#include "IndependenceDetection.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Keypad digit of a move, indexed by row change + 1 and column change + 1
+const char MOVE_CODES[3][3] = {{'7', '8', '9'}, {'4', '5', '6'}, {'1', '2', '3'}};
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string FormatMilliseconds(double milliseconds) {
+  std::ostringstream text;
+  text << std::fixed << std::setprecision(3) << milliseconds;
+  return text.str();
+}
+
+}  // namespace
+
+SolverService::Connection::~Connection() {
+  if (owned) {
+    close(output_fd);
+  }
+}
+
+SolverService::SolverService(ManagerSetup _setup, int thread_count)
+  : setup(std::move(_setup)),
+    pool(thread_count > 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::shared_ptr<Manager> SolverService::GetManager(const std::string& map_name) {
+  // The lock only covers the table; the first request for a map loads it and the others wait on its future
+  std::shared_future<std::shared_ptr<Manager>> loaded;
+  std::promise<std::shared_ptr<Manager>> loading;
+  bool loader = false;
+  {
+    std::lock_guard<std::mutex> lock(managers_mutex);
+    auto it = managers.find(map_name);
+    if (it != managers.end()) {
+      loaded = it->second;
+    } else {
+      loaded = loading.get_future().share();
+      managers.emplace(map_name, loaded);
+      loader = true;
+    }
+  }
+  if (!loader) {
+    return loaded.get();
+  }
+
+  try {
+    auto manager = std::make_shared<Manager>();
+    manager->InitializeMap(map_name);
+    manager->SetQuiet(true);
+    setup(*manager);
+
+    // Requests create their solvers concurrently, so nothing may be built lazily from here on
+    manager->PrepareHierarchy();
+    loading.set_value(manager);
+    return manager;
+  } catch (...) {
+    // Waiting requests see the error; a later request tries the load again
+    loading.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> lock(managers_mutex);
+    managers.erase(map_name);
+    throw;
+  }
+}
+
+std::string SolverService::HandleRequest(const std::string& line, std::chrono::steady_clock::time_point received) {
+  std::istringstream fields(line);
+  std::string command;
+  fields >> command;
+  if (command == "solve") {
+    return Solve(fields, received);
+  }
+  if (command == "load") {
+    std::string map_name;
+    if (!(fields >> map_name)) {
+      return "error - load needs a map name";
+    }
+    try {
+      GetManager(map_name);
+    } catch (const std::exception& e) {
+      return "error - " + std::string(e.what());
+    }
+    return "loaded " + map_name + " " + FormatMilliseconds(MillisecondsSince(received));
+  }
+  return "error - unknown command: " + command;
+}
+
+std::string SolverService::Solve(std::istringstream& fields, std::chrono::steady_clock::time_point received) {
+  std::string id, map_name, engine;
+  double deadline_ms = 0;
+  int count = 0;
+  if (!(fields >> id)) {
+    return "error - solve needs a request ID";
+  }
+  if (!(fields >> map_name >> engine >> deadline_ms >> count) || deadline_ms <= 0 || count <= 0) {
+    return "error " + id + " expected: solve <id> <map> <engine|-> <deadline-ms> <count> <agents...>";
+  }
+
+  try {
+    std::shared_ptr<Manager> manager = GetManager(map_name);
+    if (count > manager->GetMap()->GetCellCount()) {
+      return "error " + id + " more agents than cells";
+    }
+    std::vector<AgentData> entries(count);
+    for (int i = 0; i < count; i++) {
+      AgentData& entry = entries[i];
+      if (!(fields >> entry.start_row >> entry.start_col >> entry.dest_row >> entry.dest_col)) {
+        return "error " + id + " expected " + std::to_string(count) + " agents of four coordinates each";
+      }
+      entry.agent_id = i;
+      entry.optimal_distance = 0;
+    }
+
+    std::vector<std::shared_ptr<Agent>> agents = manager->CreateAgents(entries);
+    SolverType type = engine == "-" ? manager->GetSolverType() : Manager::ParseSolverType(engine);
+
+    // The map is shared with the other requests, and standard output may carry the replies
+    std::shared_ptr<Solver> solver = manager->CreateSolver(agents, type);
+    solver->SetUpdateMap(false);
+    solver->SetVerbose(false);
+    solver->SetDeadline(received + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double, std::milli>(deadline_ms)));
+    if (auto id_solver = std::dynamic_pointer_cast<IndependenceDetection>(solver); id_solver && pool.GetThreadCount() > 1) {
+      id_solver->SetThreadCount(1);  // Concurrent requests already keep every core busy
+    }
+    bool found = solver->PathFind();
+    std::string runtime = FormatMilliseconds(MillisecondsSince(received));
+    if (!found) {
+      return "fail " + id + (solver->TimedOut() ? " timeout " : " no-solution ") + runtime;
+    }
+
+    std::ostringstream reply;
+    long long cost = 0;
+    for (const auto& agent : agents) {
+      cost += agent->GetPath().size();
+    }
+    reply << "ok " << id << " " << cost << " " << runtime;
+    for (const auto& agent : agents) {
+      reply << " " << EncodePath(agent->GetPath());
+    }
+    return reply.str();
+  } catch (const std::exception& e) {
+    return "error " + id + " " + e.what();
+  }
+}
+
+std::string SolverService::EncodePath(const std::vector<std::shared_ptr<Cell>>& path) {
+  std::string encoded = std::to_string(path[0]->row) + "," + std::to_string(path[0]->col) + ":";
+  encoded.reserve(encoded.size() + path.size());
+  for (size_t t = 1; t < path.size(); t++) {
+    encoded += MOVE_CODES[path[t]->row - path[t - 1]->row + 1][path[t]->col - path[t - 1]->col + 1];
+  }
+  return encoded;
+}
+
+void SolverService::WriteReply(Connection& connection, const std::string& reply) {
+  std::string line = reply + "\n";
+  std::lock_guard<std::mutex> lock(connection.mutex);
+  for (size_t written = 0; written < line.size();) {
+    ssize_t count = write(connection.output_fd, line.data() + written, line.size() - written);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;  // The client went away; its remaining replies are dropped
+    }
+    written += count;
+  }
+}
+
+void SolverService::ReadRequests(int input_fd, std::shared_ptr<Connection> connection) {
+  std::string buffer;
+  char chunk[4096];
+  bool input_open = true;
+  while (input_open || !buffer.empty()) {
+    size_t newline = buffer.find('\n');
+    if (newline == std::string::npos && input_open) {
+      ssize_t count = read(input_fd, chunk, sizeof(chunk));
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count > 0) {
+        buffer.append(chunk, count);
+        continue;
+      }
+      input_open = false;
+      continue;
+    }
+
+    // Without a line break the rest of the input is the last line
+    std::string line = buffer.substr(0, newline);
+    buffer.erase(0, newline == std::string::npos ? buffer.size() : newline + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.find_first_not_of(" \t") == std::string::npos) {
+      continue;
+    }
+    if (line == "quit") {
+      return;
+    }
+
+    auto received = std::chrono::steady_clock::now();
+    pool.Submit([this, connection, line, received]() {
+      WriteReply(*connection, HandleRequest(line, received));
+    });
+  }
+}
+
+void SolverService::Serve(int input_fd, int output_fd) {
+  auto connection = std::make_shared<Connection>();
+  connection->output_fd = output_fd;
+  ReadRequests(input_fd, connection);
+  pool.Wait();
+}
+
+bool SolverService::ServeSocket(const std::string& path) {
+  sockaddr_un address{};
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Error: Socket path is too long: " << path << std::endl;
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (server_fd < 0 || bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+      listen(server_fd, SOMAXCONN) < 0) {
+    std::cerr << "Error: Cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+    if (server_fd >= 0) {
+      close(server_fd);
+    }
+    return false;
+  }
+
+  // A client that disconnects early must not end the process when its reply is written
+  std::signal(SIGPIPE, SIG_IGN);
+  std::cerr << "Listening on " << path << std::endl;
+  while (true) {
+    int client_fd = accept(server_fd, nullptr, nullptr);
+    if (client_fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+      close(server_fd);
+      return false;
+    }
+
+    // The descriptor closes once the reader and every queued reply are done with it
+    auto connection = std::make_shared<Connection>();
+    connection->output_fd = client_fd;
+    connection->owned = true;
+    std::thread([this, client_fd, connection]() { ReadRequests(client_fd, connection); }).detach();
+  }
+}
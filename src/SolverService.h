@@ -0,0 +1,162 @@
+/**
+ * @file SolverService.h
+ * @brief Defines the long-lived solver service that answers requests on warm maps.
+ *
+ * A dispatcher that sends many small queries should not pay for process
+ * start, map parsing and heuristic tables on every one. The service loads
+ * each map once, keeps it with its distance tables, landmarks and HPA*
+ * abstraction for the lifetime of the process, and solves requests on a
+ * pool of worker threads.
+ *
+ * Requests and replies are single text lines, on standard input and output
+ * or on the connections of a Unix domain socket:
+ *
+ *     solve <id> <map> <engine|-> <deadline-ms> <count> <start-row> <start-col> <goal-row> <goal-col> ...
+ *     load <map>
+ *     quit
+ *
+ * Replies arrive in the order requests finish, so they carry the request ID:
+ *
+ *     ok <id> <sum-of-costs> <runtime-ms> <row>,<col>:<moves> ...
+ *     fail <id> <timeout|no-solution> <runtime-ms>
+ *     error <id> <message>
+ *     loaded <map> <load-ms>
+ *
+ * A path is its start cell followed by one move per time step, as numeric
+ * keypad digits: 8 up (row - 1), 2 down, 4 left, 6 right, 7, 9, 1 and 3
+ * diagonally, and 5 to wait.
+ */
+
+#ifndef SOLVER_SERVICE_H
+#define SOLVER_SERVICE_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <sstream>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+#include "Manager.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Solves path requests on maps that stay loaded between requests.
+ */
+class SolverService {
+public:
+    /**
+     * @brief Applies the engine settings to the manager of a newly loaded map.
+     *
+     * Runs once per map, right after the map is loaded and before any
+     * request on it; it may build landmarks and other tables on the map.
+     */
+    using ManagerSetup = std::function<void(Manager& manager)>;
+
+    /**
+     * @brief Constructs a service with no maps loaded.
+     *
+     * @param _setup Configures the manager of each map
+     * @param thread_count Requests solved at the same time, 0 for one per hardware thread
+     */
+    SolverService(ManagerSetup _setup, int thread_count);
+
+    /**
+     * @brief Gets the manager of a map, loading the map on first use.
+     *
+     * Calls for a map that is still loading wait for that load; calls for
+     * other maps go ahead.
+     *
+     * @param map_name Map name, as for the -m option
+     * @return Manager holding the loaded map
+     * @throw std::runtime_error if the map cannot be loaded
+     */
+    std::shared_ptr<Manager> GetManager(const std::string& map_name);
+
+    /**
+     * @brief Answers one request line.
+     *
+     * Safe to call from several threads at once.
+     *
+     * @param line Request without the line break
+     * @param received When the request arrived; its deadline counts from here
+     * @return Reply without the line break
+     */
+    std::string HandleRequest(const std::string& line,
+                              std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now());
+
+    /**
+     * @brief Answers requests from a pair of file descriptors until the input ends or says quit.
+     *
+     * Requests are solved on the worker threads while further lines are
+     * read; each reply is written as one line as soon as it is ready.
+     * Returns after the replies to all requests read so far were written.
+     *
+     * @param input_fd Descriptor requests are read from
+     * @param output_fd Descriptor replies are written to
+     */
+    void Serve(int input_fd, int output_fd);
+
+    /**
+     * @brief Accepts connections on a Unix domain socket and serves each one on its own reader thread.
+     *
+     * Only returns if the socket cannot be set up or stops accepting connections.
+     *
+     * @param path File system path of the socket; an existing file there is replaced
+     * @return false (after printing an error) if the socket cannot be created
+     */
+    bool ServeSocket(const std::string& path);
+
+private:
+    /**
+     * @brief Reply channel shared by the requests of one input.
+     */
+    struct Connection {
+        int output_fd;       ///< Descriptor replies are written to
+        std::mutex mutex;    ///< Keeps replies from interleaving
+        bool owned = false;  ///< Whether the descriptor is closed with the connection
+        ~Connection();
+    };
+
+    ManagerSetup setup;  ///< Configures the manager of each map
+    ThreadPool pool;     ///< Workers that solve the requests
+    std::mutex managers_mutex;  ///< Guards managers, not the loads
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<Manager>>> managers;  ///< Loaded and loading maps by name
+
+    /**
+     * @brief Reads request lines and queues them until the input ends or says quit.
+     *
+     * @param input_fd Descriptor requests are read from
+     * @param connection Where the replies go
+     */
+    void ReadRequests(int input_fd, std::shared_ptr<Connection> connection);
+
+    /**
+     * @brief Solves a parsed solve request.
+     *
+     * @param fields Request fields after the command
+     * @param received When the request arrived
+     * @return Reply line
+     */
+    std::string Solve(std::istringstream& fields, std::chrono::steady_clock::time_point received);
+
+    /**
+     * @brief Writes one reply line.
+     *
+     * @param connection Where the reply goes
+     * @param reply Reply without the line break
+     */
+    static void WriteReply(Connection& connection, const std::string& reply);
+
+    /**
+     * @brief Encodes a path as its start cell and keypad moves.
+     *
+     * @param path Path to encode, not empty
+     * @return The encoded path
+     */
+    static std::string EncodePath(const std::vector<std::shared_ptr<Cell>>& path);
+};
+
+#endif // SOLVER_SERVICE_H
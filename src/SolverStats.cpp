@@ -0,0 +1,54 @@
+#include "SolverStats.h"
+#include <sstream>
+
+std::string SearchStats::ToJson() const {
+  std::ostringstream json;
+  json << "{\"stats_enabled\": " << (STATS_ENABLED ? "true" : "false")
+       << ", \"expansions\": " << expansions
+       << ", \"generated\": " << generated
+       << ", \"constraint_lookups\": " << constraint_lookups
+       << ", \"search_ms\": " << search_ms << "}";
+  return json.str();
+}
+
+void SolverStats::AddSearch(const SearchStats& search) {
+  low_level_calls++;
+  low_level_expansions += search.expansions;
+  low_level_generated += search.generated;
+  constraint_lookups += search.constraint_lookups;
+  low_level_ms += search.search_ms;
+}
+
+void SolverStats::Merge(const SolverStats& other) {
+  high_level_generated += other.high_level_generated;
+  high_level_expanded += other.high_level_expanded;
+  low_level_calls += other.low_level_calls;
+  low_level_expansions += other.low_level_expansions;
+  low_level_generated += other.low_level_generated;
+  constraint_lookups += other.constraint_lookups;
+  root_planning_ms += other.root_planning_ms;
+  conflict_detection_ms += other.conflict_detection_ms;
+  low_level_ms += other.low_level_ms;
+}
+
+std::string SolverStats::ToJson() const {
+  // Averages per search; 0 when nothing was searched
+  auto per_call = [this](double total) {
+    return low_level_calls > 0 ? total / low_level_calls : 0.0;
+  };
+
+  std::ostringstream json;
+  json << "{\"stats_enabled\": " << (STATS_ENABLED ? "true" : "false")
+       << ", \"high_level_generated\": " << high_level_generated
+       << ", \"high_level_expanded\": " << high_level_expanded
+       << ", \"low_level_calls\": " << low_level_calls
+       << ", \"low_level_expansions\": " << low_level_expansions
+       << ", \"low_level_generated\": " << low_level_generated
+       << ", \"expansions_per_call\": " << per_call(low_level_expansions)
+       << ", \"generated_per_call\": " << per_call(low_level_generated)
+       << ", \"constraint_lookups\": " << constraint_lookups
+       << ", \"root_planning_ms\": " << root_planning_ms
+       << ", \"conflict_detection_ms\": " << conflict_detection_ms
+       << ", \"low_level_ms\": " << low_level_ms << "}";
+  return json.str();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file SolverStats.h
+ * @brief Defines the counters and phase timers reported by the solvers.
+ *
+ * A few counters are always kept, because batch runs report them. The
+ * detailed ones only exist in builds with MAPF_ENABLE_STATS defined (CMake
+ * option of the same name); otherwise the MAPF_STATS macros expand to
+ * nothing, so the hot loops carry no counting or clock reads at all.
+ */
+
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <chrono>
+#include <string>
+
+#ifdef MAPF_ENABLE_STATS
+/// Runs a statement that only updates statistics
+#define MAPF_STATS(statement) statement
+/// Adds the time until the end of the enclosing scope to a millisecond field
+#define MAPF_STATS_TIMER(name, target) ScopedTimer name(target)
+#else
+#define MAPF_STATS(statement) ((void)0)
+#define MAPF_STATS_TIMER(name, target) ((void)0)
+#endif
+
+/**
+ * @brief Whether this build collects the detailed statistics.
+ */
+#ifdef MAPF_ENABLE_STATS
+constexpr bool STATS_ENABLED = true;
+#else
+constexpr bool STATS_ENABLED = false;
+#endif
+
+/**
+ * @brief Adds the lifetime of the timer to a millisecond counter.
+ */
+class ScopedTimer {
+public:
+    /**
+     * @brief Starts timing.
+     *
+     * @param _target Counter the elapsed milliseconds are added to
+     */
+    explicit ScopedTimer(double& _target) : target(_target), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        target += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    double& target;                                ///< Counter to add to
+    std::chrono::steady_clock::time_point start;   ///< When timing started
+};
+
+/**
+ * @brief Work done by one low-level A* search.
+ *
+ * Only `expansions` is counted in every build.
+ */
+struct SearchStats {
+    long long expansions = 0;          ///< Nodes taken from the open list and expanded
+    long long generated = 0;           ///< Nodes pushed onto the open list
+    long long constraint_lookups = 0;  ///< Moves and waits checked against the constraints
+    double search_ms = 0.0;            ///< Time spent in the search
+
+    /**
+     * @brief Formats the statistics as a one-line JSON object.
+     */
+    std::string ToJson() const;
+};
+
+/**
+ * @brief Work done by one Solver::PathFind() call.
+ *
+ * The high-level expansions and the low-level calls and expansions are
+ * counted in every build; the other fields stay 0 unless MAPF_ENABLE_STATS
+ * is defined.
+ */
+struct SolverStats {
+    long long high_level_generated = 0;   ///< High-level nodes created, e.g. CBS constraint tree nodes
+    long long high_level_expanded = 0;    ///< High-level nodes taken from the open list
+    long long low_level_calls = 0;        ///< A* searches run (path cache hits are not searches)
+    long long low_level_expansions = 0;   ///< Nodes expanded by all A* searches
+    long long low_level_generated = 0;    ///< Nodes generated by all A* searches
+    long long constraint_lookups = 0;     ///< Constraint checks made by all A* searches
+    double root_planning_ms = 0.0;        ///< Time spent planning the initial paths
+    double conflict_detection_ms = 0.0;   ///< Time spent searching solutions for conflicts
+    double low_level_ms = 0.0;            ///< Time spent in A* searches
+
+    /**
+     * @brief Adds the work of one A* search.
+     */
+    void AddSearch(const SearchStats& search);
+
+    /**
+     * @brief Adds the work of another PathFind(), e.g. of a sub-solver.
+     */
+    void Merge(const SolverStats& other);
+
+    /**
+     * @brief Formats the statistics as a one-line JSON object, with per-search averages.
+     */
+    std::string ToJson() const;
+};
+
+#endif // SOLVER_STATS_H
@@ -0,0 +1,55 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int thread_count) {
+  thread_count = std::max(1, thread_count);
+  workers.reserve(thread_count);
+  for (int i = 0; i < thread_count; i++) {
+    workers.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  task_available.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(task));
+  }
+  task_available.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  all_done.wait(lock, [this]() { return tasks.empty() && active_count == 0; });
+}
+
+void ThreadPool::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    task_available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+    if (tasks.empty()) {
+      return;  // Stopping, and everything queued has run
+    }
+
+    std::function<void()> task = std::move(tasks.front());
+    tasks.pop();
+    active_count++;
+    lock.unlock();
+    task();
+    lock.lock();
+    active_count--;
+    if (tasks.empty() && active_count == 0) {
+      all_done.notify_all();
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file ThreadPool.h
+ * @brief Defines a fixed-size pool of worker threads for independent tasks.
+ *
+ * Batch runs solve many instances that share nothing but the read-only
+ * map, so they are spread over a few long-lived threads instead of
+ * starting one thread per instance.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @brief Runs submitted tasks on a fixed set of worker threads, in submission order.
+ *
+ * Tasks must not throw; catch inside the task and report the error through
+ * its own result.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     *
+     * @param thread_count Number of worker threads, at least 1
+     */
+    explicit ThreadPool(int thread_count);
+
+    /**
+     * @brief Finishes all queued tasks and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task for the next free worker.
+     *
+     * @param task Work to run
+     */
+    void Submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     */
+    void Wait();
+
+    /**
+     * @brief Gets the number of worker threads.
+     */
+    int GetThreadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    std::vector<std::thread> workers;               ///< Worker threads
+    std::queue<std::function<void()>> tasks;        ///< Tasks not started yet
+    std::mutex mutex;                               ///< Guards tasks, active_count and stopping
+    std::condition_variable task_available;         ///< Signals workers that a task was queued or the pool stops
+    std::condition_variable all_done;               ///< Signals Wait() that the queue drained
+    int active_count = 0;                           ///< Tasks currently running
+    bool stopping = false;                          ///< Set by the destructor
+
+    /**
+     * @brief Takes and runs tasks until the pool stops.
+     */
+    void WorkerLoop();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,64 @@
+#include "Visualizer.h"
+#include <SFML/Graphics.hpp>
+
+void Visualizer::ShowMap(const Map& map, const std::string& title) {
+  const int cellSize = 20; // Size of each cell in pixels
+  sf::RenderWindow window(sf::VideoMode(map.GetWidth() * cellSize, map.GetHeight() * cellSize), title);
+
+  std::unordered_map<char, sf::Color> colorMap = {
+      {'.', sf::Color::White},
+      {'@', sf::Color::Black},
+      {'A', sf::Color::Red},
+      {'B', sf::Color::Blue},
+      {'C', sf::Color::Green},
+      {'D', sf::Color::Yellow},
+      {'E', sf::Color::Magenta},
+      {'F', sf::Color::Cyan} // Add more mappings as needed
+  };
+
+  while (window.isOpen()) {
+    sf::Event event;
+    while (window.pollEvent(event)) {
+      if (event.type == sf::Event::Closed)
+        window.close();
+    }
+
+    window.clear();
+    for (int row = 0; row < map.GetHeight(); ++row) {
+      for (int col = 0; col < map.GetWidth(); ++col) {
+        sf::RectangleShape cellShape(sf::Vector2f(cellSize, cellSize));
+        cellShape.setPosition(col * cellSize, row * cellSize);
+
+        char icon = map.GetIcon(row, col);
+        uint32_t agent_bits = map.GetAgentIcons(row, col);
+        
+        if (icon == '.' || icon == '@') {
+          cellShape.setFillColor(colorMap[icon]);
+        }
+        else if (agent_bits != 0) {
+          int totalR = 0, totalG = 0, totalB = 0, count = 0;
+          for (int letter = 0; letter < 26; ++letter) {
+            if ((agent_bits >> letter & 1u) == 0) continue;
+            count++;
+            if (colorMap.find('A' + letter) != colorMap.end()) {
+              sf::Color color = colorMap['A' + letter];
+              totalR += color.r;
+              totalG += color.g;
+              totalB += color.b;
+            }
+          }
+          sf::Color blendedColor(totalR / count, totalG / count, totalB / count);
+          cellShape.setFillColor(blendedColor);
+        } else {
+          cellShape.setFillColor(sf::Color::Green); // Default color for unknown characters
+        }
+
+        cellShape.setOutlineColor(sf::Color::Black);
+        cellShape.setOutlineThickness(1);
+        window.draw(cellShape);
+      }
+    }
+
+    window.display();
+  }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file Visualizer.h
+ * @brief Defines the SFML window that draws a map and the agents' paths.
+ *
+ * This is the only part of the program that depends on SFML. It is built
+ * into the MultiAgentPathfinding visualizer, not into mapf_core, so the
+ * headless solver runs on machines without a display.
+ */
+
+#ifndef VISUALIZER_H
+#define VISUALIZER_H
+
+#include <string>
+#include "Map.h"
+
+/**
+ * @brief Draws maps in SFML windows.
+ */
+class Visualizer {
+public:
+    /**
+     * @brief Opens a window showing a map and blocks until it is closed.
+     *
+     * Cells crossed by several agents get the blend of their colors.
+     *
+     * @param map Map to draw, with the icons marked by the last solution
+     * @param title Window title
+     */
+    static void ShowMap(const Map& map, const std::string& title = "Map Visualization");
+};
+
+#endif // VISUALIZER_H
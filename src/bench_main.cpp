@@ -0,0 +1,143 @@
+/**
+ * @file bench_main.cpp
+ * @brief Main entry point of the kernel microbenchmarks.
+ *
+ * Loads a map and a scenario, times the hot kernels of the solvers one by
+ * one and prints time and allocations per call. With --save the results
+ * become a baseline; with --compare a later run is checked against it and
+ * the program fails if a kernel regressed, so it can gate a change.
+ */
+
+#include "Microbenchmark.h"
+#include "Manager.h"
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Options of a benchmark run, with their default values.
+ */
+struct BenchConfig {
+    std::string map_name = "maze-32-32-4";
+    std::string scenario_folder = "maze-32-32-2";
+    std::string scenario_name = "maze-32-32-2-even-1";
+    double min_time = 0.5;
+    std::string filter;
+    std::string save_path;
+    std::string compare_path;
+    double tolerance = 10.0;
+};
+
+void PrintUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]\n"
+              << "Options:\n"
+              << "  -m, --map <name>         Map name (default: maze-32-32-4)\n"
+              << "  -f, --folder <name>      Scenario folder (default: maze-32-32-2)\n"
+              << "  -s, --scenario <name>    Scenario name (default: maze-32-32-2-even-1)\n"
+              << "  --min-time <seconds>     Minimum measured time per kernel (default: 0.5)\n"
+              << "  --filter <text>          Only run kernels whose name contains this text\n"
+              << "  --save <file>            Store the results as a baseline CSV file\n"
+              << "  --compare <file>         Compare against a baseline, failing on regressions\n"
+              << "  --tolerance <percent>    Allowed slowdown before a kernel regresses (default: 10)\n"
+              << "  -h, --help               Show this help message\n";
+}
+
+/**
+ * @brief Reads a positive number option, exiting with an error message on invalid values.
+ */
+double ParsePositive(const char* value, const char* what) {
+    try {
+        double number = std::stod(value);
+        if (number <= 0) {
+            throw std::invalid_argument(std::string(what) + " must be positive");
+        }
+        return number;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid " << what << ". " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+BenchConfig ParseArguments(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage(argv[0]);
+            exit(0);
+        }
+        else if ((arg == "-m" || arg == "--map") && has_value) {
+            config.map_name = argv[++i];
+        }
+        else if ((arg == "-f" || arg == "--folder") && has_value) {
+            config.scenario_folder = argv[++i];
+        }
+        else if ((arg == "-s" || arg == "--scenario") && has_value) {
+            config.scenario_name = argv[++i];
+        }
+        else if (arg == "--min-time" && has_value) {
+            config.min_time = ParsePositive(argv[++i], "minimum time");
+        }
+        else if (arg == "--filter" && has_value) {
+            config.filter = argv[++i];
+        }
+        else if (arg == "--save" && has_value) {
+            config.save_path = argv[++i];
+        }
+        else if (arg == "--compare" && has_value) {
+            config.compare_path = argv[++i];
+        }
+        else if (arg == "--tolerance" && has_value) {
+            config.tolerance = ParsePositive(argv[++i], "tolerance");
+        }
+        else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            PrintUsage(argv[0]);
+            exit(1);
+        }
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config = ParseArguments(argc, argv);
+
+    try {
+        // Read the baseline first, so a bad path fails before the measurements
+        std::vector<KernelResult> baseline;
+        if (!config.compare_path.empty()) {
+            baseline = Microbenchmark::ReadBaseline(config.compare_path);
+        }
+
+        auto map = std::make_shared<Map>(config.map_name);
+        std::string scenario_path = Manager::SCENARIO_FOLDER_PATH + config.scenario_folder + "/" +
+                                    config.scenario_name + ".scen";
+        Microbenchmark benchmark(map, Manager::ReadScenario(scenario_path));
+        benchmark.SetMinTime(config.min_time);
+
+        std::vector<KernelResult> results = benchmark.Run(config.filter);
+        if (results.empty()) {
+            std::cerr << "Error: No kernel matches " << config.filter << std::endl;
+            return 1;
+        }
+
+        if (!config.save_path.empty() && !Microbenchmark::WriteBaseline(config.save_path, results)) {
+            return 1;
+        }
+        if (baseline.empty()) {
+            Microbenchmark::Print(results);
+            return 0;
+        }
+
+        int regressions = Microbenchmark::Compare(results, baseline, config.tolerance / 100.0);
+        if (regressions > 0) {
+            std::cerr << regressions << " kernel(s) regressed against " << config.compare_path << std::endl;
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,200 @@
+/**
+ * @file generate_main.cpp
+ * @brief Main entry point of the instance generator.
+ *
+ * Generates a map of a chosen layout and size and a set of scenarios for
+ * it, and writes them where the solver looks for them: the map to
+ * tests/maps and the scenarios to a folder of the same name in
+ * tests/scenarios. Like the solver, it is run from the build directory.
+ */
+
+#include "InstanceGenerator.h"
+#include "Manager.h"
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Options of a generator run, with their default values.
+ */
+struct GeneratorConfig {
+    std::string kind = "random";
+    int width = 256;
+    int height = 256;
+    double density = 0.2;
+    int shelf_length = 10;
+    int corridor_width = 2;
+    int room_size = 7;
+    int agents_count = 100;
+    int scenarios = 1;
+    uint64_t seed = 1;
+    MovementType movement = MovementType::OCTILE;
+    std::string name;
+};
+
+void PrintUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]\n"
+              << "Options:\n"
+              << "  -k, --kind <kind>        Map layout: random, warehouse, rooms, maze (default: random)\n"
+              << "  --width <cells>          Map width (default: 256)\n"
+              << "  --height <cells>         Map height (default: 256)\n"
+              << "  --density <fraction>     Obstacle density of random maps (default: 0.2)\n"
+              << "  --shelf-length <cells>   Shelf length of warehouse maps (default: 10)\n"
+              << "  --corridor <cells>       Aisle width of warehouses, corridor width of mazes (default: 2)\n"
+              << "  --room-size <cells>      Room side length of room maps (default: 7)\n"
+              << "  -a, --agents <number>    Agents per scenario (default: 100)\n"
+              << "  --scenarios <number>     Number of scenario files (default: 1)\n"
+              << "  --seed <number>          Random seed (default: 1)\n"
+              << "  --movement <type>        octile or manhattan (default: octile)\n"
+              << "  -n, --name <name>        Map and scenario folder name (default: <kind>-<width>-<height>)\n"
+              << "  -h, --help               Show this help message\n";
+}
+
+/**
+ * @brief Reads a positive integer option, exiting with an error message on invalid values.
+ */
+int ParsePositiveInt(const char* value, const char* what) {
+    try {
+        int number = std::stoi(value);
+        if (number <= 0) {
+            throw std::invalid_argument(std::string(what) + " must be positive");
+        }
+        return number;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid " << what << ". " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+GeneratorConfig ParseArguments(int argc, char* argv[]) {
+    GeneratorConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage(argv[0]);
+            exit(0);
+        }
+        else if ((arg == "-k" || arg == "--kind") && has_value) {
+            config.kind = argv[++i];
+            try {
+                InstanceGenerator::ParseMapKind(config.kind);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--width" && has_value) {
+            config.width = ParsePositiveInt(argv[++i], "width");
+        }
+        else if (arg == "--height" && has_value) {
+            config.height = ParsePositiveInt(argv[++i], "height");
+        }
+        else if (arg == "--density" && has_value) {
+            try {
+                config.density = std::stod(argv[++i]);
+                if (config.density < 0 || config.density >= 1) {
+                    throw std::invalid_argument("Density must be at least 0 and below 1");
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Invalid density. " << e.what() << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--shelf-length" && has_value) {
+            config.shelf_length = ParsePositiveInt(argv[++i], "shelf length");
+        }
+        else if (arg == "--corridor" && has_value) {
+            config.corridor_width = ParsePositiveInt(argv[++i], "corridor width");
+        }
+        else if (arg == "--room-size" && has_value) {
+            config.room_size = ParsePositiveInt(argv[++i], "room size");
+        }
+        else if ((arg == "-a" || arg == "--agents") && has_value) {
+            config.agents_count = ParsePositiveInt(argv[++i], "agent count");
+        }
+        else if (arg == "--scenarios" && has_value) {
+            config.scenarios = ParsePositiveInt(argv[++i], "scenario count");
+        }
+        else if (arg == "--seed" && has_value) {
+            try {
+                config.seed = std::stoull(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Invalid seed. " << e.what() << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--movement" && has_value) {
+            std::string movement = argv[++i];
+            if (movement == "octile") {
+                config.movement = MovementType::OCTILE;
+            } else if (movement == "manhattan") {
+                config.movement = MovementType::MANHATTAN;
+            } else {
+                std::cerr << "Error: Unknown movement type: " << movement << std::endl;
+                exit(1);
+            }
+        }
+        else if ((arg == "-n" || arg == "--name") && has_value) {
+            config.name = argv[++i];
+        }
+        else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            PrintUsage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if (config.name.empty()) {
+        config.name = config.kind + "-" + std::to_string(config.width) + "-" + std::to_string(config.height);
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorConfig config = ParseArguments(argc, argv);
+
+    // Build the map
+    InstanceGenerator generator(config.width, config.height, config.seed);
+    switch (InstanceGenerator::ParseMapKind(config.kind)) {
+        case MapKind::RANDOM:
+            generator.GenerateRandom(config.density);
+            break;
+        case MapKind::WAREHOUSE:
+            generator.GenerateWarehouse(config.shelf_length, config.corridor_width);
+            break;
+        case MapKind::ROOMS:
+            generator.GenerateRooms(config.room_size);
+            break;
+        case MapKind::MAZE:
+            generator.GenerateMaze(config.corridor_width);
+            break;
+    }
+
+    std::string map_path = Map::MAP_FOLDER_PATH + config.name + ".map";
+    if (!generator.WriteMap(map_path, config.movement)) {
+        return 1;
+    }
+    std::cout << "Map: " << map_path << " (" << config.width << "x" << config.height << ", "
+              << generator.CountFreeCells() << " free cells)" << std::endl;
+
+    // Draw the scenarios on the map as the solver will load it
+    try {
+        Map map(config.name);
+        std::string folder = Manager::SCENARIO_FOLDER_PATH + config.name;
+        std::filesystem::create_directories(folder);
+        for (int i = 1; i <= config.scenarios; i++) {
+            std::string scenario_path = folder + "/" + config.name + "-random-" + std::to_string(i) + ".scen";
+            std::vector<AgentData> agents = generator.GenerateAgents(map, config.agents_count);
+            if (!InstanceGenerator::WriteScenario(scenario_path, config.name + ".map", map, agents)) {
+                return 1;
+            }
+            std::cout << "Scenario: " << scenario_path << " (" << agents.size() << " agents)" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
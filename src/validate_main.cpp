@@ -0,0 +1,141 @@
+/**
+ * @file validate_main.cpp
+ * @brief Main entry point of the solution validator.
+ *
+ * Checks a solution file written with --solution against the map and the
+ * scenario it was solved for, without running any engine. Prints the
+ * first violations in detail and fails if there is any, so it can check
+ * solutions produced at scale, e.g. after every batch run.
+ */
+
+#include "SolutionValidator.h"
+#include "Manager.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Options of a validator run, with their default values.
+ */
+struct ValidateConfig {
+    std::string map_name = "maze-32-32-4";
+    std::string scenario_folder = "maze-32-32-2";
+    std::string scenario_name = "maze-32-32-2-even-1";
+    int agents_count = -1;
+    int max_violations = SolutionValidator::DEFAULT_MAX_VIOLATIONS;
+    std::string solution_path;
+};
+
+void PrintUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] <solution file>\n"
+              << "Options:\n"
+              << "  -m, --map <name>         Map name (default: maze-32-32-4)\n"
+              << "  -f, --folder <name>      Scenario folder (default: maze-32-32-2)\n"
+              << "  -s, --scenario <name>    Scenario name (default: maze-32-32-2-even-1)\n"
+              << "  -a, --agents <number>    Scenario agents solved (default: one per path in the file)\n"
+              << "  --max-violations <n>     Violations reported before stopping (default: 10)\n"
+              << "  -h, --help               Show this help message\n";
+}
+
+/**
+ * @brief Reads a positive integer option, exiting with an error message on invalid values.
+ */
+int ParsePositiveInt(const char* value, const char* what) {
+    try {
+        int number = std::stoi(value);
+        if (number <= 0) {
+            throw std::invalid_argument(std::string(what) + " must be positive");
+        }
+        return number;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid " << what << ". " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+ValidateConfig ParseArguments(int argc, char* argv[]) {
+    ValidateConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-h" || arg == "--help") {
+            PrintUsage(argv[0]);
+            exit(0);
+        }
+        else if ((arg == "-m" || arg == "--map") && has_value) {
+            config.map_name = argv[++i];
+        }
+        else if ((arg == "-f" || arg == "--folder") && has_value) {
+            config.scenario_folder = argv[++i];
+        }
+        else if ((arg == "-s" || arg == "--scenario") && has_value) {
+            config.scenario_name = argv[++i];
+        }
+        else if ((arg == "-a" || arg == "--agents") && has_value) {
+            config.agents_count = ParsePositiveInt(argv[++i], "agent count");
+        }
+        else if (arg == "--max-violations" && has_value) {
+            config.max_violations = ParsePositiveInt(argv[++i], "violation count");
+        }
+        else if (config.solution_path.empty() && !arg.empty() && arg[0] != '-') {
+            config.solution_path = arg;
+        }
+        else {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            PrintUsage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if (config.solution_path.empty()) {
+        std::cerr << "Error: No solution file given" << std::endl;
+        PrintUsage(argv[0]);
+        exit(1);
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    ValidateConfig config = ParseArguments(argc, argv);
+
+    try {
+        Map map(config.map_name);
+        std::vector<AgentPath> paths = SolutionValidator::ReadSolution(config.solution_path, map);
+        int agents_count = config.agents_count > 0 ? config.agents_count : static_cast<int>(paths.size());
+        std::string scenario_path = Manager::SCENARIO_FOLDER_PATH + config.scenario_folder + "/" +
+                                    config.scenario_name + ".scen";
+        std::vector<AgentData> agents = Manager::ReadScenario(scenario_path, agents_count);
+        if (static_cast<int>(agents.size()) < agents_count) {
+            std::cerr << "Error: Scenario " << config.scenario_name << " has only " << agents.size()
+                      << " agents" << std::endl;
+            return 1;
+        }
+
+        SolutionValidator validator(map);
+        validator.SetMaxViolations(config.max_violations);
+        auto start = std::chrono::steady_clock::now();
+        bool valid = validator.Validate(agents, paths);
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (!valid) {
+            const auto& violations = validator.GetViolations();
+            std::cout << "Invalid solution:" << std::endl;
+            for (const Violation& violation : violations) {
+                std::cout << "  " << validator.Describe(violation) << std::endl;
+            }
+            if (static_cast<int>(violations.size()) == config.max_violations) {
+                std::cout << "Stopped after " << violations.size() << " violations" << std::endl;
+            }
+            return 1;
+        }
+        std::cout << "Valid solution: " << agents.size() << " agents, makespan " << validator.GetMakespan()
+                  << ", sum of costs " << validator.GetSumOfCosts() << " (checked in " << std::fixed
+                  << std::setprecision(2) << elapsed_ms << " ms)" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file visualizer_main.cpp
+ * @brief Main entry point of the multi-agent pathfinding visualizer.
+ * 
+ * Runs the same steps as the headless solver, then shows the initial and
+ * the final map state in two SFML windows.
+ */
+
+#include <iostream>
+#include <thread>
+#include "CommandLine.h"
+#include "Visualizer.h"
+
+int main(int argc, char* argv[]) {
+    // Parse command line arguments
+    Config config = ParseArguments(argc, argv);
+    
+    // Validate input files
+    if (!ValidateFiles(config)) {
+        return 1;
+    }
+    
+    // Preprocess the map instead of planning
+    Manager manager;
+    if (config.preprocess) {
+        return RunPreprocess(manager, config) ? 0 : 1;
+    }
+    
+    // Answer requests until the input ends
+    if (config.serve) {
+        return RunService(config) ? 0 : 1;
+    }
+    
+    // Benchmark the whole scenario folder instead of one scenario
+    if (config.batch) {
+        return RunBatch(manager, config) ? 0 : 1;
+    }
+    
+    // Create a copy of the initial map state
+    Manager initial_manager;
+    try {
+        initial_manager.InitializeMap(config.map_name);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    // Run pathfinding
+    if (!RunPathfinding(manager, config)) {
+        return 1;
+    }
+    
+    // Show visualizations
+    std::thread initial_thread([&initial_manager]() {
+        Visualizer::ShowMap(*initial_manager.GetMap(), "Initial Map State");
+    });
+    
+    std::thread final_thread([&manager]() {
+        Visualizer::ShowMap(*manager.GetMap(), "Final Map State");
+    });
+    
+    initial_thread.join();
+    final_thread.join();
+    
+    return 0;
+}